@@ -950,6 +950,32 @@ CFLAGS=$ac_save_CFLAGS
 CPPFLAGS="$CPPFLAGS $sfs_cv_pthread_h"
 LIBS="$ac_save_LIBS $sfs_cv_libpthread"])
 
+dnl
+dnl Optional pthreads for the threaded aiod back end.  Unlike
+dnl SFS_FIND_PTHREADS, a missing library is not an error; aiod
+dnl just sticks to helper processes.
+dnl
+AC_DEFUN([SFS_AIO_THREADS],
+[AC_ARG_ENABLE(aio-threads,
+--disable-aio-threads     Don't run aiod requests on threads)
+AC_CHECK_HEADERS(sys/eventfd.h)
+if test "$enable_aio_threads" != no; then
+    AC_CACHE_CHECK(for pthreads for aiod, sfs_cv_aio_pthread,
+    [ac_save_LIBS=$LIBS
+    sfs_cv_aio_pthread=no
+    for lflags in " " "-lpthread"; do
+	LIBS="$ac_save_LIBS $lflags"
+	AC_TRY_LINK([#include <pthread.h>],
+	    pthread_create (0, 0, 0, 0);,
+	    sfs_cv_aio_pthread=$lflags; break)
+    done
+    LIBS=$ac_save_LIBS])
+    if test "$sfs_cv_aio_pthread" != no; then
+	LIBS="$LIBS $sfs_cv_aio_pthread"
+	AC_DEFINE(HAVE_AIO_THREADS, 1,
+	    Define if aiod can run requests on threads)
+    fi
+fi])
 dnl
 dnl Find PCRE
 dnl
@@ -2485,6 +2511,30 @@ if test "$sfs_cv_kqueue" = yes; then
 	     Define if this machine has FreeBSD kqueue support)
 fi])
 dnl
+dnl SFS_AIO_URING
+dnl
+dnl  Let aiod use Linux io_uring, if the headers are new enough
+dnl
+AC_DEFUN([SFS_AIO_URING],
+[AC_ARG_ENABLE(aio-uring,
+--disable-aio-uring       Don't let aiod use io_uring)
+if test "$enable_aio_uring" != no; then
+AC_CACHE_CHECK(for io_uring, sfs_cv_aio_uring,
+AC_TRY_COMPILE([
+#include <sys/syscall.h>
+#include <sys/stat.h>
+#include <linux/io_uring.h>
+], [
+   struct statx stx;
+   int op = IORING_OP_LINKAT;
+   syscall (__NR_io_uring_setup, 0, 0);
+], sfs_cv_aio_uring=yes, sfs_cv_aio_uring=no))
+if test "$sfs_cv_aio_uring" = yes; then
+	AC_DEFINE(HAVE_AIO_URING, 1,
+	     Define if aiod can use Linux io_uring)
+fi
+fi])
+dnl
 dnl SFS_INIT_LDVERSION
 dnl
 AC_DEFUN([SFS_INIT_LDVERSION],
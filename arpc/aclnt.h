@@ -148,11 +148,16 @@ private:
 
   cbv::ptr send_hook;
   cbv::ptr recv_hook;
+  bool send_deadlines;
 
   aclnt (const axprt &);
   const aclnt &operator= (const aclnt &);
 
   static void seteof (ref<xhinfo>);
+  callbase *call1 (u_int32_t procno, const void *in, void *out, aclnt_cb,
+		   AUTH *auth, sfs::xdrproc_t inproc, sfs::xdrproc_t outproc,
+		   u_int32_t progno, u_int32_t versno, sockaddr *d,
+		   u_int32_t deadline);
 
 protected:
   aclnt (const ref<xhinfo> &x, const rpc_program &rp);
@@ -181,12 +186,14 @@ public:
   static void dispatch (ref<xhinfo>, const char *, ssize_t, const sockaddr *);
   static bool marshal_call (xdrsuio &, AUTH *auth, u_int32_t progno,
 			    u_int32_t versno, u_int32_t procno,
-			    sfs::xdrproc_t inproc, const void *in);
+			    sfs::xdrproc_t inproc, const void *in,
+			    u_int32_t deadline = 0);
   bool init_call (xdrsuio &x,
 		  u_int32_t procno, const void *in, void *out, aclnt_cb &,
 		  AUTH *auth = NULL,
 		  sfs::xdrproc_t inproc = NULL, sfs::xdrproc_t outproc = NULL,
-		  u_int32_t progno = 0, u_int32_t versno = 0);
+		  u_int32_t progno = 0, u_int32_t versno = 0,
+		  u_int32_t deadline = 0);
 
   callbase *call (u_int32_t procno, const void *in, void *out, aclnt_cb,
 		  AUTH *auth = NULL,
@@ -220,6 +227,13 @@ public:
   void set_send_hook (cbv::ptr cb) { send_hook = cb; }
   void set_recv_hook (cbv::ptr cb) { recv_hook = cb; }
 
+  /* With this on, timedcall and scall tell the server how long they
+   * will wait, in the call's verifier (as AUTH_DEADLINE), so that it
+   * can skip calls given up on.  asrv understands this; other
+   * servers may reject the verifier, so it is off by default.  Calls
+   * whose auth has a verifier of its own send no deadline. */
+  void set_send_deadlines (bool on) { send_deadlines = on; }
+
   static ptr<aclnt> alloc (ref<axprt> x, const rpc_program &pr,
 			   const sockaddr *d = NULL,
 			   rpccb_alloc_t ra = NULL);
@@ -0,0 +1,112 @@
+// -*-c++-*-
+/* $Id$ */
+
+/*
+ * aclnt_pool keeps TCP connections to a set of servers of one RPC
+ * program and spreads calls over them.  Each server added gets n
+ * connections.  A call goes to the connection with the fewest calls
+ * outstanding (LEAST_OUTSTANDING), or to the less busy of two picked
+ * at random (TWO_CHOICES), which keeps many clients from all piling
+ * onto the same idle server.  Connections that fail or cannot be
+ * made are retried on the schedule of a tmoq (backoff.h): at once,
+ * then after 1, 2, 4, 8 and 16 seconds, then every 32.  The schedule
+ * starts over only for connections that stayed up past the next
+ * try.  Calls made while no connection is up wait for one.
+ *
+ * When its connection fails, a call to a procedure marked idempotent
+ * is sent again on another, up to set_retries times; other calls
+ * fail with the error.  Arguments are marshaled when the call is
+ * made, so the caller need not keep them.  A timeout, if given,
+ * applies to each attempt and to the wait for a connection.
+ */
+
+#ifndef _ARPC_ACLNT_POOL_H_
+#define _ARPC_ACLNT_POOL_H_ 1
+
+#include "arpc.h"
+
+class aclnt_pool : public virtual refcount {
+public:
+  enum policy_t { LEAST_OUTSTANDING, TWO_CHOICES };
+
+private:
+  struct conn {
+    aclnt_pool *const pool;
+    const str host;
+    const u_int16_t port;
+    ptr<aclnt> c;
+    u_int outstanding;
+    tcpconnect_t *tcpc;
+    bool reconnecting;
+    tmoq_entry<conn> tlink;
+
+    conn (aclnt_pool *p, str h, u_int16_t port);
+    ~conn ();
+    bool up () const { return c && !c->xi->ateof (); }
+    void reconnect ();
+    void connected (int fd);
+    void eof ();
+    void xmit (u_int n);	// For the tmoq: try again, if down
+    void timeout ();		// For the tmoq: out of tries
+  };
+
+  struct poolcall {
+    const ref<aclnt_pool> pool;
+    const u_int32_t procno;
+    void *const out;
+    const aclnt_cb cb;
+    const time_t tmo;
+    char *args;
+    size_t argslen;
+    u_int tries;
+    conn *cur;
+    timecb_t *waittmo;
+    tailq_entry<poolcall> link;
+
+    poolcall (ref<aclnt_pool> p, u_int32_t procno, void *out, aclnt_cb cb,
+	      time_t tmo);
+    ~poolcall ();
+    void send ();
+    void sendto (conn *);
+    void done (clnt_stat);
+    void expire ();
+    static BOOL xdr_args (XDR *, void *);
+  };
+
+  const policy_t _policy;
+  const axprtalloc_fn _xa;
+  vec<conn *> _conns;
+  vec<conn *> _up;
+  vec<bool> _idempotent;
+  u_int _retries;
+  u_int _nconnected;
+  u_int _rotor;
+  tailq<poolcall, &poolcall::link> _waiting;
+
+  static tmoq<conn, &conn::tlink, 1, 6> reconnq;
+
+  conn *pick ();
+  void runwaiting ();
+
+protected:
+  aclnt_pool (const rpc_program &, policy_t, axprtalloc_fn);
+  ~aclnt_pool ();
+
+public:
+  const rpc_program &rp;
+  u_int64_t nretried;		// Calls sent again after a failure
+
+  static ref<aclnt_pool> alloc (const rpc_program &rp,
+				policy_t p = TWO_CHOICES,
+				axprtalloc_fn xa = axprt_stream_alloc_default);
+
+  void add (str host, u_int16_t port, u_int n = 1);
+  void set_idempotent (u_int32_t procno, bool on = true);
+  void set_retries (u_int n) { _retries = n; }
+  u_int nconnected () const { return _nconnected; }
+
+  void call (u_int32_t procno, const void *in, void *out, aclnt_cb cb,
+	     time_t timeout = 0);
+};
+
+#endif /* !_ARPC_ACLNT_POOL_H_ */
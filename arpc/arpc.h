@@ -46,6 +46,7 @@ extern bool_t xdr_callmsg (XDR *, struct rpc_msg *);
 #endif /* !HAVE___SETERR_REPLY */
 
 #define AUTH_UINT 10
+#define AUTH_DEADLINE 11	// Verifier: milliseconds the caller will wait
 AUTH *authuint_create (u_int32_t val);
 u_int32_t authuint_getval (AUTH *auth);
 AUTH *authopaque_create ();
@@ -57,6 +57,11 @@ class svccb {
 
   timespec ts_start;            // keep track of when it started
 
+  bool admitted;		// Counted against the limits
+  u_int32_t peer;		// Counted against this peer's limit
+  timespec ts_expire;		// When waiting for admission ends
+  timespec ts_deadline;		// When the caller gives up, if it said
+
   svccb (const svccb &);	// No copying
   const svccb &operator= (const svccb &);
 
@@ -84,6 +89,13 @@ public:
 
   const ptr<asrv> &getsrv () const { return srv; }
 
+  /* When the caller will stop waiting for the reply, if it said so
+   * (see aclnt::set_send_deadlines); tv_sec is 0 if not.  Calls are
+   * dropped, unanswered, if this passes before they are dispatched;
+   * long-running procedures can check expired () as they go. */
+  const timespec &deadline () const { return ts_deadline; }
+  bool expired () const;
+
   void *getvoidarg () { return arg; }
   const void *getvoidarg () const { return arg; }
   template<class T> T *getarg () { return static_cast<T *> (arg); }
@@ -129,10 +141,36 @@ private:
 
   cbv::ptr recv_hook;
 
+  u_int _maxcalls;
+  u_int _maxwait;
+  u_int _waitms;
+  u_int _ncalls;
+  u_int _nwaiting;
+  tailq<svccb, &svccb::qlink> _waitq;
+  timecb_t *_waittmo;
+  bool _paused;
+
   static void seteof (ref<xhinfo>, const sockaddr *, bool force = false);
+  void admit (svccb *);
+  bool fits (svccb *);
+  bool full () const;
+  void take (svccb *);
+  void release (svccb *);
+  void reject (svccb *);
+  void pause ();
+  void resume ();
+  void unwait (svccb *);
+  void expire ();
+  void drop (svccb *);
+  u_int32_t peerof (const svccb *);
+  static void admit_waiting ();
+  void schedule (svccb *);
+  static void run_queued ();
 
 protected:
   ptr<xhinfo> xi;
+  bool _peerknown;		// _peer is the connected caller's address
+  u_int32_t _peer;
 
   asrv (ref<xhinfo>, const rpc_program &, asrv_cb::ptr);
   virtual ~asrv ();
@@ -144,6 +182,7 @@ protected:
 public:
   const progvers pv;
   ihash_entry<asrv> xhlink;
+  tailq_entry<asrv> waitlink;
   const ref<axprt> &xprt () const;
 
   void start ();
@@ -159,6 +198,38 @@ public:
   static ptr<asrv> alloc (ref<axprt>, const rpc_program &,
 			  asrv_cb::ptr = NULL, bool fire_virtual_hook = true);
   int get_trace_fd () const;
+
+  /* Admission control.  A call counts against the limits from when
+   * it is handed to the callback until it is replied to.  Calls over
+   * a limit wait, in order, up to waitms milliseconds (0 for no
+   * deadline), and are rejected with SYSTEM_ERR when that passes or
+   * when maxwait are waiting already.  Once maxwait calls wait, the
+   * transport is not read until they go, so the backpressure reaches
+   * the client.  All limits are off (0) by default. */
+  void set_limits (u_int maxcalls, u_int maxwait = 0, u_int waitms = 0);
+  static void set_global_limits (u_int maxcalls, u_int maxperpeer = 0);
+  u_int ncalls () const { return _ncalls; }
+  u_int nwaiting () const { return _nwaiting; }
+  static u_int64_t nrejected;	// Turned away, full or expired
+  static u_int64_t nexpired;	// Dropped past the caller's deadline
+
+  /* Priority scheduling.  Once any procedure is given a class, calls
+   * are queued by class as they are read, and each pass through the
+   * event loop hands up to quantum of them to admission control,
+   * taking turns among the classes in proportion to their weights.
+   * So cheap calls do not wait behind a backlog of expensive ones.
+   * Unclassified procedures are in class 0, and every class has
+   * weight 1 until set.  Queued calls count as waiting for
+   * admission, so maxwait above bounds the queues too.  When
+   * rpc_stats is active, the time calls spend queued is reported per
+   * class. */
+  enum { nclasses = 8 };
+  static void set_class (u_int32_t prog, u_int32_t vers, u_int32_t proc,
+			 u_int cls);
+  static void set_class (const rpc_program &pr, u_int32_t proc, u_int cls)
+    { set_class (pr.progno, pr.versno, proc, cls); }
+  static void set_weight (u_int cls, u_int weight);
+  static void set_quantum (u_int n);
 };
 
 class asrv_replay : public asrv {
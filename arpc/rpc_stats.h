@@ -41,6 +41,7 @@ namespace rpc_stats {
 
   struct rpc_stats_t {
     void init(u_int64_t time_delta); 
+    void add(u_int64_t time_delta);
     
     u_int32_t count;
     u_int64_t time_sum;
@@ -107,12 +108,17 @@ namespace rpc_stats {
     void end_call(uint32_t prog, uint32_t vers, uint32_t proc, 
                   const timespec &strt);
 
+    /** Call this when a call queued in priority class cls since strt
+     * is dispatched; printed as RPC-QUEUE lines */
+    void end_queue(u_int32_t cls, const timespec &strt);
+
   protected:
     bool m_active;
     u_int32_t m_interval;
     timespec m_last_print;
     size_t m_n_per_line;
     qhash<rpc_proc_t, rpc_stats_t> m_stats;
+    qhash<u_int32_t, rpc_stats_t> m_queue_stats;
 
     void output_line (size_t i, const strbuf &p, strbuf &l, bool frc);
   };
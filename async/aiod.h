@@ -28,6 +28,7 @@
 #include "async.h"
 #include "bbuddy.h"
 #include "ihash.h"
+#include "list.h"
 #include "aiod_prot.h"
 #include "sfs_bundle.h"
 
@@ -36,6 +37,16 @@ struct aiod_req;
 // gcc 4.1 fixes
 class aiod;
 class aiofh;
+class aiothr;
+class aioring;
+class aiostream;
+
+/* Where aiod carries out requests */
+enum aiod_engine {
+  AIOD_PROCS = 0,		// aiod daemons
+  AIOD_THREADS = 1,		// Threads in this process
+  AIOD_URING = 2,		// io_uring, with daemons for the rest
+};
 
 class aiobuf {
   friend class aiod;
@@ -129,6 +140,8 @@ class aiod {
 
   const size_t ndaemons;
   daemon *dv;
+  aiothr *thr;
+  aioring *ring;
 
   int fhno_ctr;
   vec<int> fhno_avail;
@@ -138,6 +151,10 @@ class aiod {
   void delreq (request *r);
   void fail ();
   void input (int);
+  void thrinput ();
+  void ringinput ();
+  void complete (const aiomsg_t *op, size_t n);
+  void growbuf (size_t inc);
   void bufwake ();
   void bufalloc_cb1 (size_t inc, ptr<aiobuf> buf);
   void bufalloc_cb2 (size_t inc, ptr<aiobuf> buf);
@@ -187,9 +204,22 @@ public:
   enum { minbuf = 0x40 };
   const size_t maxbuf;
 
+  /* With AIOD_THREADS, requests are carried out by nproc threads in
+   * this process instead of by nproc aiod daemons, and the buffers
+   * live in ordinary memory.  This saves a pipe write, a context
+   * switch and a socket read per request.
+   *
+   * With AIOD_URING, the daemons are started as usual, but opens,
+   * reads, writes, fsyncs, stats and most path operations go to the
+   * kernel through io_uring instead, many requests to a system call.
+   *
+   * Unlike the daemons, both create files subject to the process
+   * umask.  Where libasync or the kernel lacks support for either,
+   * aiod falls back to daemons alone. */
   aiod (u_int nproc = 1, ssize_t shmsize = 0x200000,
 	size_t maxbuf = 0x10000, bool shmpin = false,
-	str path = NULL, str tmpdir = NULL);
+	str path = NULL, str tmpdir = NULL,
+	aiod_engine engine = AIOD_PROCS);
   void finalize () { finalized = true; addref (); delref (); }
 
   ptr<aiobuf> bufalloc (size_t len);
@@ -256,6 +286,7 @@ aiod::request::request (ref<aiobuf> b)
 
 class aiofh : public virtual refcount {
   friend class aiod;
+  friend class aiostream;
 
   typedef callback<void, ptr<aiobuf>, ssize_t, int>::ref cbrw;
 
@@ -324,4 +355,149 @@ public:
 };
 
 
+struct aiostream_stats {
+  u_int64_t reads;		// Calls to read
+  u_int64_t hits;		// Reads served without waiting on aiod
+  u_int64_t prefetched;		// Bytes read ahead
+  u_int64_t wasted;		// Bytes read ahead but never read
+  u_int64_t writes;		// Calls to write
+  u_int64_t flushes;		// Coalesced writes sent to aiod
+  u_int64_t direct;		// Reads and writes passed straight through
+};
+
+/*
+ * A stream cache for one aiofh.  Once a handle has been read
+ * sequentially for a couple of calls, aiostream reads ahead up to
+ * depth aligned blocks of blksize bytes, and serves later reads by
+ * copying out of them.  Writes are copied into a buffer that
+ * collects contiguous data up to the next block boundary, and the
+ * caller is called back from a timer, as for reads served from
+ * memory; the buffer goes to aiod when full, after flushdelay
+ * milliseconds, or on flush, close or read.  The first error from
+ * such a write is reported by the next write, flush or close.
+ * Random access goes straight to the aiofh.  A write to aiod that
+ * overlaps one still in flight waits for it, and later writes wait
+ * behind that one, so several daemons cannot land them out of
+ * order.
+ *
+ * All I/O on the handle must go through the stream.
+ */
+class aiostream : public virtual refcount {
+  typedef aiofh::cbrw cbrw;
+
+  struct rablk {
+    const off_t pos;
+    ptr<aiobuf> buf;
+    ssize_t len;		// -1 while the read is outstanding
+    int err;
+    size_t used;		// Bytes handed out to readers
+    bool stale;			// Dropped while the read was outstanding
+    vec<cbv> waiters;
+    tailq_entry<rablk> link;
+    rablk (off_t p, ptr<aiobuf> b)
+      : pos (p), buf (b), len (-1), err (0), used (0), stale (false) {}
+  };
+
+  struct rdreq {
+    const off_t pos;
+    const ptr<aiobuf> buf;
+    const u_int start;
+    const u_int size;
+    const cbrw cb;
+    u_int done;
+    bool waited;
+    rdreq (off_t p, ptr<aiobuf> b, u_int s, u_int n, cbrw c)
+      : pos (p), buf (b), start (s), size (n), cb (c),
+	done (0), waited (false) {}
+  };
+
+  struct wrreq {
+    const off_t pos;
+    const ptr<aiobuf> buf;
+    const u_int start;
+    const u_int size;
+    const cbrw cb;
+    tailq_entry<wrreq> link;
+    wrreq (off_t p, ptr<aiobuf> b, u_int s, u_int n, cbrw c)
+      : pos (p), buf (b), start (s), size (n), cb (c) {}
+    bool overlaps (const wrreq *w) const
+      { return pos < w->pos + off_t (w->size)
+	  && w->pos < pos + off_t (size); }
+  };
+
+  aiod *const iod;
+  const ref<aiofh> fh;
+  const size_t blksize;
+  const u_int depth;
+
+  tailq<rablk, &rablk::link> blks;
+  u_int nblks;
+  off_t nextpos;		// Where a sequential read would start
+  u_int run;			// Sequential reads so far
+
+  ptr<aiobuf> wbuf;
+  off_t wpos;
+  size_t wlen;
+  size_t wcap;
+  u_int nflushing;		// Writes to aiod, in flight or queued
+  int werr;
+  timecb_t *wtmo;
+  vec<cbv> idlewait;
+  tailq<wrreq, &wrreq::link> wflight;
+  tailq<wrreq, &wrreq::link> wqueue;	// Waiting on an overlapping write
+
+  aiostream_stats stats;
+
+  rablk *lookup (off_t pos);
+  rablk *fetch (off_t pos);
+  void fetch_cb (rablk *b, ptr<aiobuf>, ssize_t n, int err);
+  void drop (rablk *b);
+  void dropall ();
+  void prefetch ();
+  void serve (rdreq *r);
+  void direct_cb (rdreq *r, ptr<aiobuf>, ssize_t n, int err);
+  void complete (rdreq *r, ssize_t n, int err);
+  void finish (rdreq *r, ssize_t n, int err);
+
+  void writeout (wrreq *w);
+  void issue (wrreq *w);
+  bool inflight (const wrreq *w);
+  void written (wrreq *w, ptr<aiobuf> buf, ssize_t n, int err);
+  void flushbuf ();
+  void flush_cb (size_t len, ptr<aiobuf>, ssize_t n, int err);
+  void flush_tmo ();
+  void through_cb (ptr<aiobuf> buf, u_int size, u_int rest, cbrw cb,
+		   ptr<aiobuf>, ssize_t n, int err);
+  void idle ();
+  void sread2 (sfs::bundle_t<off_t, ptr<aiobuf>, u_int, u_int> b, cbrw cb)
+    { sread (b.obj1 (), b.obj2 (), b.obj3 (), b.obj4 (), cb); }
+  void flush2 (cbi cb);
+  void close2 (cbi cb, int err);
+  static void close_cb (int ferr, cbi cb, int err);
+
+protected:
+  ~aiostream ();
+
+public:
+  enum { seqmin = 2 };
+  u_int flushdelay;
+
+  aiostream (ref<aiofh> fh, size_t blksize = 0x10000, u_int depth = 4);
+
+  void read (off_t pos, ptr<aiobuf> buf, cbrw cb)
+    { sread (pos, buf, 0, buf->size (), cb); }
+  void sread (off_t pos, ptr<aiobuf> buf, u_int iostart, u_int iosize,
+	      cbrw cb);
+  void write (off_t pos, ptr<aiobuf> buf, cbrw cb)
+    { swrite (pos, buf, 0, buf->size (), cb); }
+  void swrite (off_t pos, ptr<aiobuf> buf, u_int iostart, u_int iosize,
+	       cbrw cb);
+  void flush (cbi cb);
+  void close (cbi cb);
+
+  ptr<aiofh> getfh () { return fh; }
+  const aiostream_stats &getstats () const { return stats; }
+};
+
+
 #endif /* !_ASYNC_AIOD_H_ */
@@ -0,0 +1,268 @@
+// -*-c++-*-
+/* $Id$ */
+
+/*
+ *
+ * Copyright (C) 1998 David Mazieres (dm@uun.org)
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License as
+ * published by the Free Software Foundation; either version 2, or (at
+ * your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307
+ * USA
+ *
+ */
+
+#ifndef _ASYNC_AIOSRV_H_
+#define _ASYNC_AIOSRV_H_ 1
+
+/*
+ * The server half of the aiod protocol: code that carries out the
+ * requests found in the shared buffer.  The aiod program runs one
+ * aiosrv per process.  The threaded back end of class aiod (see
+ * aiothr below) runs one per thread.  Either way, each aiosrv keeps
+ * its own table of open files, which is why aiofh sends a close to
+ * every one of them.
+ */
+
+#include "amisc.h"
+#include "aiod_prot.h"
+#include "qhash.h"
+#include <dirent.h>
+
+#ifdef HAVE_AIO_THREADS
+#include <pthread.h>
+#endif /* HAVE_AIO_THREADS */
+
+class fhtab {
+  struct fh {
+    const int fd;
+    const dev_t dev;
+    const ino_t ino;
+    const char *const path;
+
+    fh (int f, dev_t d, ino_t i, const char *p)
+      : fd (f), dev (d), ino (i), path (xstrdup (p)) {}
+    ~fh () { ::close (fd); xfree (const_cast<char *> (path)); }
+  };
+
+  qhash<int, ref<fh> > tab;
+
+  fh *alloc (aiod_file *af, int *errp, bool create = false, mode_t mode = 0);
+public:
+  u_int nstale;			// Stale handles found, for aiosrv to report
+
+  fhtab () : nstale (0) {}
+  int lookup (aiod_file *af, int *errp);
+  int create (aiod_file *af, mode_t mode, int *errp);
+  int close (aiod_file *af, int *errp);
+};
+
+class dhtab {
+  struct fh {
+    DIR *fd;
+    const dev_t dev;
+    const ino_t ino;
+    const char *const path;
+
+    fh (DIR *f, dev_t d, ino_t i, const char *p)
+      : fd (f), dev (d), ino (i), path (xstrdup (p)) {}
+    ~fh () { ::closedir (fd); xfree (const_cast<char *> (path)); }
+  };
+
+  qhash<int, ref<fh> > tab;
+
+  fh *alloc (aiod_file *af, int *errp);
+public:
+  u_int nstale;			// Stale handles found, for aiosrv to report
+
+  dhtab () : nstale (0) {}
+  DIR *lookup (aiod_file *af, int *errp);
+  int create (aiod_file *af, int *errp);
+  int close (aiod_file *af, int *errp);
+};
+
+class shmbuf {
+  char *const buf;
+  const size_t len;
+  const bool mapped;
+
+protected:
+  ~shmbuf ();
+
+public:
+  const int fd;
+  shmbuf (int f, void *buf, size_t len, bool mapped = false)
+    : buf (static_cast<char *> (buf)), len (len), mapped (mapped), fd (f) {}
+
+  template<class T> T *getptr (aiomsg_t pos) {
+#ifdef CHECK_BOUNDS
+    assert (/*pos >= 0 && */pos + sizeof (T) <= len);
+#endif /* CHECK_BOUNDS */
+    return reinterpret_cast<T *> (buf + pos);
+  }
+  aiod_op getop (aiomsg_t pos) {
+#ifdef CHECK_BOUNDS
+    assert (/*pos >= 0 &&*/ pos + sizeof (aiod_op) <= len);
+#endif /* CHECK_BOUNDS */
+    return *reinterpret_cast<aiod_op *> (buf + pos);
+  }
+  void *getbuf (aiod_iobuf *bp) {
+#ifdef CHECK_BOUNDS
+    assert (/*bp->buf >= 0 && */bp->buf + (size_t) bp->len <= len);
+#endif /* CHECK_BOUNDS */
+    return buf + bp->buf;
+  }
+  static ptr<shmbuf> alloc (int fd);
+};
+
+template<> inline void *
+shmbuf::getptr<void> (aiomsg_t pos)
+{
+#ifdef CHECK_BOUNDS
+    assert (/*pos >= 0 && */pos <= len);
+#endif /* CHECK_BOUNDS */
+    return buf + pos;
+}
+
+class aiosrv {
+  fhtab fht;
+  dhtab dht;
+  const ref<shmbuf> buf;
+  const bool threaded;
+
+  void nop (aiomsg_t);
+  void pathop (aiomsg_t);
+  void fhop (aiomsg_t);
+  void fstat (aiomsg_t);
+  void dhop (aiomsg_t);
+  void mkdir (aiomsg_t);
+public:
+  /* A threaded aiosrv avoids anything that affects the whole process
+   * (such as chdir).  Nor does it call warn, which is not safe
+   * outside the main thread: it counts what it would have warned
+   * about, and whoever runs it collects the count with takestale
+   * and warns from the main thread. */
+  aiosrv (ref<shmbuf> b, bool threaded = false)
+    : buf (b), threaded (threaded) {}
+  void run (aiomsg_t msg);
+  u_int takestale ();
+};
+
+#ifdef HAVE_AIO_THREADS
+/*
+ * A pool of threads, each running its own aiosrv, that stands in
+ * for a set of aiod processes.  Requests are handed over in memory
+ * rather than through pipes.  Finished requests are collected in a
+ * list, and fd becomes readable (through an eventfd where there is
+ * one, or a pipe) whenever that list goes from empty to non-empty.
+ */
+class aiothr {
+  struct worker {
+    aiothr *pool;
+    pthread_t tid;
+    aiosrv *srv;
+    vec<aiomsg_t> q;		// Requests for this thread alone
+  };
+
+  pthread_mutex_t mtx;
+  pthread_cond_t cv;
+  bool stop;
+  vec<aiomsg_t> q;		// Requests for any thread
+  vec<aiomsg_t> done;
+  u_int nstale;			// Stale handles, for getdone to report
+  const u_int nthr;
+  worker *wv;
+  int wfd;
+
+  static void *start (void *);
+  void loop (worker *w);
+  void wake ();
+
+public:
+  int fd;
+
+  aiothr (void *base, size_t len, u_int n);
+  ~aiothr ();
+  void submit (aiomsg_t msg, int dst = -1);
+  void getdone (vec<aiomsg_t> *out);
+};
+#endif /* HAVE_AIO_THREADS */
+
+#ifdef HAVE_AIO_URING
+#include <linux/io_uring.h>
+
+struct timecb_t;
+
+/*
+ * Carries out the common requests itself through Linux io_uring, so
+ * that the aiod daemons only see what the ring can't do (readlink,
+ * getcwd, statvfs, directories, ftruncate, and any operation the
+ * running kernel lacks).  Requests queued during one pass through
+ * the event loop go to the kernel in a single io_uring_enter, from a
+ * timer.  Completions are read straight off the ring whenever fd is
+ * readable.
+ *
+ * Files opened through the ring are read, written, synced and
+ * fstat'ed through the ring.  The daemons still get every close, for
+ * any descriptors they opened on their own (for ftruncate, say).
+ */
+class aioring {
+  struct ringop;
+
+  const ref<shmbuf> buf;
+  char *const base;
+  u_int32_t *sqhead;
+  u_int32_t *sqtail;
+  u_int32_t *sqmask;
+  u_int32_t *sqflags;
+  u_int32_t *sqarray;
+  u_int32_t *cqhead;
+  u_int32_t *cqtail;
+  u_int32_t *cqmask;
+  io_uring_sqe *sqes;
+  io_uring_cqe *cqes;
+  void *sqmap;
+  void *cqmap;
+  size_t sqmaplen;
+  size_t cqmaplen;
+  size_t sqeslen;
+  u_int32_t sqentries;
+  u_int32_t nqueued;		// In the ring but not yet submitted
+  bool fixed;			// Buffer is registered with the kernel
+  bool curpos;			// Reads and writes can use the file offset
+  bool ops[256];		// IORING_OP_ codes the kernel supports
+  qhash<int, int> fds;		// Open files, by aiod_file handle
+  vec<aiomsg_t> done;
+  timecb_t *tmo;
+
+  aioring (void *base, size_t len, int fd);
+  bool setup (const io_uring_params &p, size_t len);
+  io_uring_sqe *getsqe ();
+  void queue (io_uring_sqe *sqe, ringop *o);
+  void flush ();
+  void flush_cb ();
+  bool prep (io_uring_sqe *sqe, ringop *o);
+  void finish (ringop *o, int res);
+  int *getfd (aiomsg_t fh);
+
+public:
+  const int fd;
+
+  static aioring *alloc (void *base, size_t len);
+  ~aioring ();
+  bool submit (aiomsg_t msg);
+  void getdone (vec<aiomsg_t> *out);
+};
+#endif /* HAVE_AIO_URING */
+
+#endif /* !_ASYNC_AIOSRV_H_ */
@@ -58,6 +58,7 @@ char *strnnsep (char **, const char *);
 /* socket.C */
 extern in_addr inet_bindaddr;
 int inetsocket (int, u_int16_t = 0, u_int32_t = INADDR_ANY);
+int inetsocket_shared (int, u_int16_t, u_int32_t = INADDR_ANY);
 int inetsocket6 (int, u_int16_t = 0, 
                  const in6_addr& addr = in6addr_any);
 int inetsocket_resvport (int, u_int32_t = INADDR_ANY);
@@ -99,6 +100,7 @@ extern str builddir;		// For running programs in place
 extern str buildtmpdir;		// For creating files (e.g. prog.pid)
 #endif /* MAINTAINER */
 pid_t afork ();
+extern u_int afork_gen;		// Incremented in each child afork creates
 str fix_exec_path (str path, str dir = NULL);
 str find_program (const char *program);
 str find_program_plus_libsfs (const char *program);
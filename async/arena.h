@@ -27,6 +27,8 @@
 
 #include "async.h"
 
+extern memtag arena_memtag;
+
 class arena {
 protected:
   enum { resv = sizeof (void *) };
@@ -35,14 +37,16 @@ protected:
   u_int avail;
   char *chunk;
   char *cur;
+  memtag *const tag;
+  size_t total;			// Bytes and chunks charged to tag
+  u_int nchunks;
 
   void newchunk (size_t);
 
  public:
-  arena () {
-    size = avail = 0;
-    chunk = cur = 0;
-  }
+  explicit arena (memtag &t = arena_memtag)
+    : size (0), avail (0), chunk (0), cur (0), tag (&t), total (0),
+      nchunks (0) {}
 
   void *alloc (size_t bytes, size_t align = sizeof (double)) {
     int pad = (align - (chunk - (char *) 0)) % align;
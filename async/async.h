@@ -51,6 +51,13 @@ void yieldcb_remove (yieldcb_t *yieldcb_t);
 
 #define fdcb(f,s,c) _fdcb(f,s,c,__FILE__,__LINE__)
 
+/* cbstat.C */
+void cbstat_enable (u_int stall_ms = 0);
+void cbstat_disable ();
+void cbstat_reset ();
+void cbstat_dumpsig (int sig);
+str cbstat_report (u_int nsites = 0);
+
 /*
  * introduced in new factoring of core.C and select.C
  */
@@ -87,6 +94,17 @@ tcpconnect_t *tcpconnect_srv (str hostname, str service, u_int16_t defport,
 tcpconnect_t *tcpconnect_srv_retry (ref<srvlist> srvl, cbi cb, str *np = NULL);
 void tcpconnect_cancel (tcpconnect_t *tc);
 extern bool tcpconnect_debug;
+extern bool tcpconnect_inet6;	// Also try AAAA addresses
+extern u_int tcpconnect_stagger; // Msec between racing connect attempts
+struct tcpconnect_stats_t {
+  u_int64_t nconnect;		// Connections established
+  u_int64_t nfail;		// Connections given up on
+  u_int64_t nattempt;		// Addresses tried
+  u_int64_t nfallback;		// Connections not made to the first address
+  u_int64_t usec_total;		// Time to connect, for successes
+  u_int64_t usec_max;
+};
+extern tcpconnect_stats_t tcpconnect_stats;
 
 /* pipe2str.C */
 void pipe2str (int fd, cbs cb, int *fdp = NULL, strbuf *sb = NULL);
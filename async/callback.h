@@ -592,6 +592,57 @@ print <<'EOF';
 EOF
 print '#endif /', '* !WRAP_DEBUG *', "/\n\n";
 
+print <<"EOF";
+$bc
+ * Callback objects are small, numerous and short-lived, so unless
+ * the allocator is being debugged they come from per-size freelists
+ * rather than malloc.  Like the reference counts, the freelists are
+ * not thread-safe: callbacks belong to the thread running the event
+ * loop.  Defining NO_CBALLOC turns this off, but it must then be
+ * defined for the whole program.
+ $ec
+#if REFCNT_CLASS_ALLOC && !defined (NO_CBALLOC)
+# define WRAP_USE_CBALLOC 1
+class cballoc {
+  static void *freelist[];
+  static void *refill (size_t c);
+public:
+  enum { grain = 16, nclass = 16, maxsize = grain * nclass };
+  static void *alloc (size_t n) {
+    if (n > maxsize)
+      return ::operator new (n);
+    size_t c = (n - 1) / grain;
+    if (void *p = freelist[c]) {
+      freelist[c] = *static_cast<void **> (p);
+      return p;
+    }
+    return refill (c);
+  }
+  static void free (void *p, size_t n) {
+    if (n > maxsize) {
+      ::operator delete (p);
+      return;
+    }
+    size_t c = (n - 1) / grain;
+    *static_cast<void **> (p) = freelist[c];
+    freelist[c] = p;
+  }
+};
+
+template<class R, class B1, class B2, class B3> class callback;
+template<class R, class B1, class B2, class B3> inline void *
+refcount_alloc (const callback<R, B1, B2, B3> *, size_t n)
+{
+  return cballoc::alloc (n);
+}
+template<class R, class B1, class B2, class B3> inline void
+refcount_free (const callback<R, B1, B2, B3> *, void *p, size_t n)
+{
+  cballoc::free (p, n);
+}
+EOF
+print '#endif /', '* REFCNT_CLASS_ALLOC && !NO_CBALLOC *', "/\n\n";
+
 pfile;
 
 print <<"EOF";
@@ -685,6 +736,55 @@ maybe_nodelete_remptr (C *p, const char *fl, int *fp)
 # define callback_line_init(super...)
 #endif /* !WRAP_DEBUG */
 
+/*
+ * Callback objects are small, numerous and short-lived, so unless
+ * the allocator is being debugged they come from per-size freelists
+ * rather than malloc.  Like the reference counts, the freelists are
+ * not thread-safe: callbacks belong to the thread running the event
+ * loop.  Defining NO_CBALLOC turns this off, but it must then be
+ * defined for the whole program.
+ */
+#if REFCNT_CLASS_ALLOC && !defined (NO_CBALLOC)
+# define WRAP_USE_CBALLOC 1
+class cballoc {
+  static void *freelist[];
+  static void *refill (size_t c);
+public:
+  enum { grain = 16, nclass = 16, maxsize = grain * nclass };
+  static void *alloc (size_t n) {
+    if (n > maxsize)
+      return ::operator new (n);
+    size_t c = (n - 1) / grain;
+    if (void *p = freelist[c]) {
+      freelist[c] = *static_cast<void **> (p);
+      return p;
+    }
+    return refill (c);
+  }
+  static void free (void *p, size_t n) {
+    if (n > maxsize) {
+      ::operator delete (p);
+      return;
+    }
+    size_t c = (n - 1) / grain;
+    *static_cast<void **> (p) = freelist[c];
+    freelist[c] = p;
+  }
+};
+
+template<class R, class B1, class B2, class B3> class callback;
+template<class R, class B1, class B2, class B3> inline void *
+refcount_alloc (const callback<R, B1, B2, B3> *, size_t n)
+{
+  return cballoc::alloc (n);
+}
+template<class R, class B1, class B2, class B3> inline void
+refcount_free (const callback<R, B1, B2, B3> *, void *p, size_t n)
+{
+  cballoc::free (p, n);
+}
+#endif /* REFCNT_CLASS_ALLOC && !NO_CBALLOC */
+
 template<class R, class B1 = void, class B2 = void, class B3 = void> class callback;
 
 template<class R>
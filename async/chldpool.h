@@ -0,0 +1,66 @@
+// -*-c++-*-
+/* $Id$ */
+
+#ifndef _ASYNC_CHLDPOOL_H_
+#define _ASYNC_CHLDPOOL_H_ 1
+
+#include "async.h"
+#include "list.h"
+
+/*
+ * A bounded version of chldrun for CPU-heavy work (password hashing,
+ * big modular exponentiations) that should not run on the event
+ * loop.  At most maxrun children run at once; further jobs wait in
+ * FIFO order, and once maxq jobs are waiting, run refuses new ones
+ * so that a burst of requests degrades into quick failures instead
+ * of an ever-growing backlog.
+ *
+ * As with chldrun, chld runs in a forked child and writes its result
+ * to the file descriptor it is passed; cb gets everything the child
+ * wrote, or NULL if the child could not be started.
+ */
+class chldpool {
+public:
+  struct stats_t {
+    u_int64_t nrun;		// Jobs completed
+    u_int64_t nfail;		// Jobs for which cb got NULL
+    u_int64_t nrejected;	// Jobs refused because the queue was full
+    u_int64_t wait_usec;	// Total time jobs spent queued
+    u_int64_t wait_usec_max;
+    u_int64_t run_usec;		// Total time jobs spent running
+    u_int64_t run_usec_max;
+    stats_t () { bzero (this, sizeof (*this)); }
+  };
+
+private:
+  struct job {
+    const cbi chld;
+    const cbs cb;
+    timespec tq;
+    tailq_entry<job> link;
+    job (cbi c, cbs b) : chld (c), cb (b) {}
+  };
+
+  const u_int _maxrun;
+  const u_int _maxq;
+  u_int _nrun;
+  u_int _nq;
+  tailq<job, &job::link> _q;
+  stats_t _stats;
+
+  void launch (job *j);
+  void done (job *j, timespec ts, str res);
+
+public:
+  chldpool (u_int maxrun, u_int maxq);
+  ~chldpool ();
+
+  bool run (cbi chld, cbs cb);
+
+  u_int nrunning () const { return _nrun; }
+  u_int nqueued () const { return _nq; }
+  const stats_t &stats () const { return _stats; }
+  void dump_stats (const str &prefix) const;
+};
+
+#endif /* !_ASYNC_CHLDPOOL_H_ */
@@ -25,6 +25,8 @@
 #ifndef _COREBENCH_H_INCLUDED_
 #define _COREBENCH_H_INCLUDED_ 1
 
+#include <typeinfo>
+
 #if defined (__i386__)
 
 static __inline unsigned long long
@@ -69,4 +71,45 @@ extern bool do_corebench;
 inline void toggle_corebench (bool f) { do_corebench = f; }
 extern unsigned long long tia_tmp, time_in_acheck;
 
+/*
+ * Per-callback latency accounting (see cbstat.C).  CBSTAT_ENTER and
+ * CBSTAT_EXIT go around each callback the core loop makes.  The site
+ * is a file and line (as recorded by fdcb), or with a line of 0, the
+ * "file:line" string that wrap records under WRAP_DEBUG, or with a
+ * negative line, the mangled type name of the callback.
+ */
+enum cbstat_kind_t { CBSTAT_FD = 0, CBSTAT_TIME, CBSTAT_SIG, CBSTAT_CHLD,
+		     CBSTAT_LAZY, CBSTAT_YIELD };
+
+extern bool do_cbstat;
+u_int64_t cbstat_enter ();
+void cbstat_exit (u_int64_t start, cbstat_kind_t kind,
+		  const char *site, int line);
+
+#ifdef WRAP_DEBUG
+# define CBSTAT_NAME(cb) ((cb)->line)
+# define CBSTAT_NAMELINE 0
+#else /* !WRAP_DEBUG */
+# define CBSTAT_NAME(cb) (typeid (*(cb)).name ())
+# define CBSTAT_NAMELINE (-1)
+#endif /* !WRAP_DEBUG */
+
+#define CBSTAT_ENTER(site, line)		\
+  const char *cbstat_site = NULL;		\
+  int cbstat_line = 0;				\
+  u_int64_t cbstat_t0 = 0;			\
+  if (do_cbstat) {				\
+    cbstat_site = (site);			\
+    cbstat_line = (line);			\
+    cbstat_t0 = cbstat_enter ();		\
+  }
+
+#define CBSTAT_ENTER_CB(cb) CBSTAT_ENTER (CBSTAT_NAME (cb), CBSTAT_NAMELINE)
+
+#define CBSTAT_EXIT(kind)						\
+do {									\
+  if (cbstat_t0)							\
+    cbstat_exit (cbstat_t0, kind, cbstat_site, cbstat_line);		\
+} while (0)
+
 #endif /* !_COREBENCH_H_INCLUDED_ */
@@ -105,6 +105,10 @@ typedef callback<void, ptr<hostent>, int>::ref cbhent;
 dnsreq_t *dns_hostbyname (str, cbhent,
 			  bool search = false, bool addrok = true);
 dnsreq_t *dns_hostbyaddr (const in_addr, cbhent);
+/* Like dns_hostbyname, but looks up AAAA records, so the hostent
+ * has h_addrtype AF_INET6. */
+dnsreq_t *dns_host6byname (str, cbhent,
+			   bool search = false, bool addrok = true);
 
 typedef callback<void, ptr<mxlist>, int>::ref cbmxlist;
 dnsreq_t *dns_mxbyname (str, cbmxlist, bool search = false);
@@ -132,5 +136,23 @@ void printtxtlist (const char *msg, ptr<txtlist> s, int = 0);
 
 void dns_reload ();
 
+/* Replies are cached in-process according to their TTLs; see
+ * dnsimpl.h.  The default size (256 names) can be changed with the
+ * SFS_DNS_CACHE environment variable; 0 disables the cache. */
+struct dns_cache_stats {
+  u_int64_t hits;
+  u_int64_t neghits;		// Hits on cached failures (included in hits)
+  u_int64_t misses;
+  u_int64_t coalesced;		// Requests that waited on another's query
+  u_int64_t refreshes;
+  u_int64_t evictions;
+  u_int size;
+  u_int maxsize;
+  dns_cache_stats () { bzero (this, sizeof (*this)); }
+};
+void dns_cache_setsize (u_int maxsize);
+void dns_cache_flush ();
+const dns_cache_stats &dns_cache_getstats ();
+
 #endif /* !_DNS_H_ */
 
@@ -27,9 +27,11 @@
 
 #include "dnsparse.h"
 #include "ihash.h"
+#include "list.h"
 #include "backoff.h"
 
 class resolver;
+struct dnscache_entry;
 class dnsreq {
   int srchno;
 
@@ -50,13 +52,29 @@ public:
   ihash_entry<dnsreq> hlink;	// Per-id hash table link
   tmoq_entry<dnsreq> tlink;	// Retransmit queue link
 
+  dnscache_entry *ce;		// Cache entry we are querying for
+  bool cwait;			// Waiting on ce->leader, not querying
+  tailq_entry<dnsreq> wlink;	// Link in ce->waiters
+  timecb_t *ctmo;		// Pending delivery from the cache
+
   dnsreq (resolver *, str, u_int16_t, bool search = false);
   virtual ~dnsreq ();
   void start (bool);
+  void send ();
   void xmit (int = 0);
   virtual void readreply (dnsparse *) = 0;
   void timeout ();
   void fail (int);
+  void deliver (str pkt, int err, bool delay);
+  void cachedreply (str pkt, int err);
+};
+
+/* Re-issues a query for a cache entry that is still in use but about
+ * to expire, so that the next lookup doesn't have to wait. */
+class dnsreq_refresh : public dnsreq {
+public:
+  dnsreq_refresh (resolver *rp, str n, u_int16_t t) : dnsreq (rp, n, t) {}
+  void readreply (dnsparse *) { delete this; }
 };
 
 class dnsreq_a : public dnsreq {
@@ -69,6 +87,8 @@ public:
     : dnsreq (rp, n, T_A, s), checkaddr (false), cb (c) {}
   dnsreq_a (resolver *rp, str n, cbhent c, const in_addr &a)
     : dnsreq (rp, n, T_A), checkaddr (true), addr (a), cb (c) {}
+  dnsreq_a (resolver *rp, str n, cbhent c, bool s, u_int16_t t)
+    : dnsreq (rp, n, t, s), checkaddr (false), cb (c) {}
   void readreply (dnsparse *);
 };
 
@@ -116,6 +136,60 @@ public:
   void readreply (dnsparse *);
 };
 
+/*
+ * Replies are cached by (name, type) as raw packets, so each request
+ * parses a cached reply just as it would a fresh one.  Positive
+ * answers are kept for the smallest TTL in the answer section, and
+ * NXDOMAIN or empty answers for the SOA minimum (RFC 2308).  SERVFAIL
+ * is remembered for a few seconds.  While a query is outstanding,
+ * further requests for the same name and type wait for its reply
+ * rather than sending their own.  A hit in the last tenth of an
+ * entry's lifetime starts a refresh in the background.
+ */
+struct dnscache_entry {
+  const str key;
+  str pkt;			// Cached reply
+  int err;			// Cached error, if !pkt
+  bool neg;			// Cached failure or empty answer
+  time_t expire;
+  time_t refresh;		// Hits after this trigger a refresh
+  dnsreq *leader;		// Outstanding query, if any
+  tailq<dnsreq, &dnsreq::wlink> waiters;
+  ihash_entry<dnscache_entry> hlink;
+  tailq_entry<dnscache_entry> lrulink;
+
+  dnscache_entry (const str &k)
+    : key (k), err (0), neg (false), expire (0), refresh (0),
+      leader (NULL) {}
+  bool valid () const { return (pkt || err) && sfs_get_timenow () < expire; }
+  bool busy () const { return leader || waiters.first; }
+};
+
+class dnscache {
+  enum { maxttl = 86400, maxnegttl = 3600, servfailttl = 5 };
+
+  ihash<const str, dnscache_entry,
+	&dnscache_entry::key, &dnscache_entry::hlink> tab;
+  tailq<dnscache_entry, &dnscache_entry::lrulink> lru;
+  dns_cache_stats stats;
+  bool refreshing;
+
+  static str mkkey (const str &name, u_int16_t type);
+  void drop (dnscache_entry *e);
+  void trim ();
+
+public:
+  dnscache (u_int maxsize);
+  ~dnscache ();
+  bool lookup (dnsreq *r);
+  void store (dnsreq *r, dnsparse *reply, const u_char *qb, size_t n);
+  void failed (dnsreq *r, int err);
+  void detach (dnsreq *r);
+  void setsize (u_int maxsize);
+  void flush ();
+  const dns_cache_stats &getstats () const { return stats; }
+};
+
 class dnssock {
 public:
   typedef callback<void, u_char *, ssize_t>::ref cb_t;
@@ -175,6 +249,7 @@ public:
   ref<bool> destroyed;
   ihash<u_int16_t, dnsreq, &dnsreq::id, &dnsreq::hlink> reqtab;
   tmoq<dnsreq, &dnsreq::tlink, 1, 5> reqtoq;
+  dnscache cache;
 
   resolver ();
   virtual ~resolver ();
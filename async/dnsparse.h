@@ -37,6 +37,9 @@
 #ifndef T_SRV
 # define T_SRV 33
 #endif /* !T_SRV */
+#ifndef T_AAAA
+# define T_AAAA 28
+#endif /* !T_AAAA */
 
 #ifndef MAXDNAME
 # define MAXDNAME 1025
@@ -104,6 +107,7 @@ struct resrec {
   union {
     char rr_ns[MAXDNAME];
     in_addr rr_a;
+    in6_addr rr_aaaa;
     char rr_cname[MAXDNAME];
     rd_soa rr_soa;
     char rr_ptr[MAXDNAME];
@@ -152,8 +156,9 @@ public:
   bool rrparse (const u_char **, resrec *);
 
   bool skipnrecs (const u_char **, u_int);
+  bool getttl (u_int32_t *ttlp);
 
-  ptr<hostent> tohostent ();
+  ptr<hostent> tohostent (u_int16_t type = T_A);
   ptr<mxlist> tomxlist ();
   ptr<srvlist> tosrvlist ();
   ptr<txtlist> totxtlist ();
@@ -0,0 +1,115 @@
+// -*-c++-*-
+/* $Id$ */
+
+/*
+ * Memory accounting by subsystem.  A memtag counts the memory one
+ * subsystem holds.  Allocators that know the size of what they free
+ * (suio buffers, arenas, aiod buffers, tame closures, callback
+ * chunks) charge their tag exactly, through alloc and dealloc, or
+ * through xmalloc_tag and xfree_tag.  Anything else allocated through
+ * New or txmalloc while a memtag::scope is active counts toward that
+ * tag's allocation rate; operator delete is not told sizes, so such
+ * memory is not in the tag's live bytes.
+ *
+ * memstat_sample (n) additionally records the size, tag and stack of
+ * about one allocation in every n bytes made through operator new,
+ * and forgets each record when its object is deleted.  From these,
+ * memstat_report estimates which tags and which stacks hold live
+ * memory, including memory no tag covers.
+ */
+
+#ifndef _ASYNC_MEMTAG_H_
+#define _ASYNC_MEMTAG_H_ 1
+
+#include "sysconf.h"
+
+#if !defined (DMALLOC) && !defined (SIMPLE_LEAK_CHECKER)
+# define MEMSTAT_HOOKS 1
+#endif /* !DMALLOC && !SIMPLE_LEAK_CHECKER */
+
+class str;
+
+class memtag {
+  const char *const _name;
+  memtag *const _next;
+  static memtag *_all;
+
+public:
+  /* Tags must have static storage duration.  The constructor leaves
+   * the counters alone, as a tag can be charged during static
+   * initialization, before its constructor has run. */
+  explicit memtag (const char *name) : _name (name), _next (_all)
+    { _all = this; }
+
+  u_int64_t nlive;		// Objects and bytes held now
+  u_int64_t live;
+  u_int64_t nalloc;		// Allocations and bytes since startup
+  u_int64_t bytes;
+  u_int64_t rep_nalloc;		// nalloc and bytes at the last report
+  u_int64_t rep_bytes;
+
+  void alloc (size_t n) { nlive++; live += n; nalloc++; bytes += n; }
+  void dealloc (size_t n, u_int nobj = 1) { nlive -= nobj; live -= n; }
+  void charge (size_t n) { nalloc++; bytes += n; }
+
+  const char *name () const { return _name; }
+  memtag *next () const { return _next; }
+  static memtag *first () { return _all; }
+  static memtag *lookup (const char *name);
+
+  /* The tag charged for untagged allocations, per thread */
+  static __thread memtag *current;
+
+  class scope {
+    memtag *const _old;
+    scope (const scope &);
+    scope &operator= (const scope &);
+  public:
+    explicit scope (memtag &t) : _old (current) { current = &t; }
+    ~scope () { current = _old; }
+  };
+};
+
+inline void *
+xmalloc_tag (memtag &t, size_t n)
+{
+  t.alloc (n);
+  return txmalloc (n);
+}
+
+inline void
+xfree_tag (memtag &t, void *p, size_t n)
+{
+  t.dealloc (n);
+  xfree (p);
+}
+
+/* memstat.C */
+void memstat_sample (size_t interval);
+void memstat_reset ();
+void memstat_dumpsig (int sig);
+str memstat_report (u_int nstacks = 10);
+
+#ifdef MEMSTAT_HOOKS
+/* Called by operator new and delete */
+extern __thread ssize_t memstat_countdown;
+extern volatile size_t memstat_nsampled;
+void memstat_take (void *p, size_t n);
+void memstat_drop (void *p);
+
+inline void
+memstat_new (void *p, size_t n)
+{
+  if ((memstat_countdown -= n) < 0)
+    memstat_take (p, n);
+}
+
+inline void
+memstat_delete (void *p)
+{
+  if (memstat_nsampled)
+    memstat_drop (p);
+}
+#endif /* MEMSTAT_HOOKS */
+
+#endif /* !_ASYNC_MEMTAG_H_ */
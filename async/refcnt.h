@@ -161,6 +161,25 @@ enum reftype { scalar, vsize, vbase };
 template<class T, reftype = scalar> class refcounted;
 template<class T> ref<T> mkref (T *);
 
+/* The storage for a refcounted<T> comes from refcount_alloc and goes
+ * back through refcount_free.  A type can supply its own allocator by
+ * overloading these for a pointer to itself or to a base class (see
+ * cballoc in callback.h); overloads are selected with a null T *.
+ * Debugging allocators need to see every New, so they disable this. */
+#if !defined (DMALLOC) && !defined (SIMPLE_LEAK_CHECKER)
+# define REFCNT_CLASS_ALLOC 1
+inline void *
+refcount_alloc (const void *, size_t n)
+{
+  return ::operator new (n);
+}
+inline void
+refcount_free (const void *, void *p, size_t)
+{
+  ::operator delete (p);
+}
+#endif /* !DMALLOC && !SIMPLE_LEAK_CHECKER */
+
 class refcount {
   u_int refcount_cnt;
   virtual void refcount_call_finalize () = 0;
@@ -200,6 +219,7 @@ private:
 #ifndef NO_TEMPLATE_FRIENDS
   template<class U> friend class ref;
   template<class U> friend class ptr;
+  template<class U> friend class handoff;
 #else /* NO_TEMPLATE_FRIENDS */
 protected:
 #endif /* NO_TEMPLATE_FRIENDS */
@@ -214,6 +234,7 @@ protected:
   template<class T> static T *rp (const ::ptr<T> &r) { return r.p; }
   template<class T, reftype v> static T *rp (refcounted<T, v> *pp)
     { return *pp; }
+  static u_int rcnt (refcount *c) { return c->refcount_getcnt (); }
   static refcount *rc (refcount *c) { return c; } // Make gcc happy ???
   template<class T> static refcount *rc (const ::ref<T> &r) { return r.c; }
   template<class T> static refcount *rc (const ::ptr<T> &r) { return r.c; }
@@ -338,6 +359,13 @@ public:
 #else
   VA_TEMPLATE (explicit refcounted, : type2struct<T>::type, {})
 #endif
+#if REFCNT_CLASS_ALLOC
+  static void *operator new (size_t n)
+    { return refcount_alloc (static_cast<T *> (NULL), n); }
+  static void *operator new (size_t, void *p) { return p; }
+  static void operator delete (void *p, size_t n)
+    { refcount_free (static_cast<T *> (NULL), p, n); }
+#endif /* REFCNT_CLASS_ALLOC */
 };
 
 template<class T>
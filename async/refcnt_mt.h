@@ -0,0 +1,151 @@
+// -*-c++-*-
+/* $Id$ */
+
+/*
+ * Reference counting across threads.
+ *
+ * The counts in refcnt.h are plain integers, which is what makes
+ * ref<> cheap, and also why a ref<>, str or anything holding one must
+ * never be touched by two threads at once.  This file offers two ways
+ * around that, neither of which changes the single-threaded path:
+ *
+ * 1. ref_mt<T> and ptr_mt<T> count with atomic operations, for
+ *    objects that really are shared between threads.  They work like
+ *    ref<T> and ptr<T>, but only for objects allocated as
+ *    refcounted_mt<T>:
+ *
+ *      ref_mt<foo> f = New refcounted_mt<foo> (arg);
+ *      ptr_mt<foo> g = f;           // safe in any thread
+ *
+ *    A ref_mt<T> does not convert to a ref<T> or back.
+ *
+ * 2. handoff<T> moves an ordinary ptr<T> from one thread to another,
+ *    for objects that are only ever used by one thread at a time.  The
+ *    sender must give up its last reference:
+ *
+ *      handoff<foo> *h = New handoff<foo> (p);   // p is now NULL
+ *      ... pass h through a mutex-protected queue ...
+ *      ptr<foo> q = h->take ();                  // in the receiver
+ *
+ *    The counts are never touched by two threads at once, so no
+ *    atomics are needed; the queue carrying the handoff provides the
+ *    memory ordering.  handoff<str> copies the string (strings are
+ *    commonly shared), and suio contents can be handed off as a str.
+ *    Callbacks must not cross threads this way: they are allocated
+ *    from freelists that belong to the event loop's thread (see
+ *    cballoc in callback.h).
+ */
+
+#ifndef _REFCNT_MT_H_INCLUDED_
+#define _REFCNT_MT_H_INCLUDED_ 1
+
+#include "refcnt.h"
+#include "str.h"
+
+class refcount_mt {
+  u_int refcount_mt_cnt;
+  template<class U> friend class ptr_mt;
+
+  void refcount_mt_inc ()
+    { __atomic_add_fetch (&refcount_mt_cnt, 1, __ATOMIC_RELAXED); }
+  void refcount_mt_dec () {
+    if (!__atomic_sub_fetch (&refcount_mt_cnt, 1, __ATOMIC_ACQ_REL))
+      delete this;
+  }
+
+protected:
+  refcount_mt () : refcount_mt_cnt (0) {}
+  virtual ~refcount_mt () {}
+
+public:
+  u_int refcount_mt_getcnt () const
+    { return __atomic_load_n (&refcount_mt_cnt, __ATOMIC_RELAXED); }
+};
+
+template<class T>
+class refcounted_mt : public T, public refcount_mt {
+  ~refcounted_mt () {}
+public:
+#ifdef __GXX_EXPERIMENTAL_CXX0X__
+  template <typename... Params>
+  explicit refcounted_mt (Params&&... args)
+    : T (std::forward<Params> (args)...) {}
+#else
+  VA_TEMPLATE (explicit refcounted_mt, : T, {})
+#endif
+};
+
+template<class T>
+class ptr_mt {
+  template<class U> friend class ptr_mt;
+
+protected:
+  T *p;
+  refcount_mt *c;
+
+  void inc () const { if (c) c->refcount_mt_inc (); }
+  void dec () const { if (c) c->refcount_mt_dec (); }
+  void set (T *pp, refcount_mt *cc)
+    { if (cc) cc->refcount_mt_inc (); dec (); p = pp; c = cc; }
+
+public:
+  ptr_mt () : p (NULL), c (NULL) {}
+  template<class U>
+  ptr_mt (refcounted_mt<U> *pp) : p (pp), c (pp) { inc (); }
+  ptr_mt (const ptr_mt<T> &r) : p (r.p), c (r.c) { inc (); }
+  template<class U>
+  ptr_mt (const ptr_mt<U> &r) : p (r.p), c (r.c) { inc (); }
+  ~ptr_mt () { dec (); }
+
+  ptr_mt<T> &operator= (const ptr_mt<T> &r) { set (r.p, r.c); return *this; }
+  template<class U> ptr_mt<T> &operator= (const ptr_mt<U> &r)
+    { set (r.p, r.c); return *this; }
+  template<class U> ptr_mt<T> &operator= (refcounted_mt<U> *pp)
+    { set (pp, pp); return *this; }
+
+  T *get () const { return p; }
+  operator T *() const { return p; }
+  T *operator-> () const { return p; }
+  T &operator* () const { return *p; }
+};
+
+/* A ptr_mt that is never NULL */
+template<class T>
+class ref_mt : public ptr_mt<T> {
+public:
+  template<class U>
+  ref_mt (refcounted_mt<U> *pp) : ptr_mt<T> (pp) {}
+  ref_mt (const ref_mt<T> &r) : ptr_mt<T> (r) {}
+  template<class U>
+  ref_mt (const ref_mt<U> &r) : ptr_mt<T> (r) {}
+
+  ref_mt<T> &operator= (const ref_mt<T> &r)
+    { ptr_mt<T>::operator= (r); return *this; }
+  template<class U> ref_mt<T> &operator= (const ref_mt<U> &r)
+    { ptr_mt<T>::operator= (r); return *this; }
+};
+
+template<class T>
+class handoff {
+  ptr<T> _p;
+public:
+  /* Takes p's reference, which must be the only one */
+  explicit handoff (ptr<T> &p) : _p (p) {
+    p = NULL;
+    if (_p && refpriv::rcnt (refpriv::rc (_p)) != 1)
+      panic ("handoff of an object with %u other references\n",
+	     refpriv::rcnt (refpriv::rc (_p)) - 1);
+  }
+  ptr<T> take () { ptr<T> r = _p; _p = NULL; return r; }
+};
+
+template<>
+class handoff<str> {
+  str _s;
+public:
+  explicit handoff (str &s) : _s (s ? str (s.cstr (), s.len ()) : str ())
+    { s = NULL; }
+  str take () { str r = _s; _s = NULL; return r; }
+};
+
+#endif /* !_REFCNT_MT_H_INCLUDED_ */
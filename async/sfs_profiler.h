@@ -41,6 +41,39 @@ public:
   static void init ();
   static void set_core (sfs_profiler::core_t *c);
 
+  //
+  // Stack mode: the signal handler only copies the raw PCs of the
+  // interrupted stack into a ring buffer, which the main loop drains
+  // into a table of distinct stacks.  Nothing is symbolized in the
+  // process; frames come out as object+offset, for addr2line or pprof
+  // to resolve offline.
+  //
+  static void set_stacks (bool b);
+  static str dump_folded ();   // one "root;...;leaf count" line per stack
+  static str dump_pprof ();    // an uncompressed profile.proto message
+
+  //
+  // Samples taken while a tag is set are charged to it as well, as a
+  // root frame in folded output and as a "closure" label in pprof.
+  // The tag must be a static string.  Returns the previous tag.
+  //
+  static const char *set_tag (const char *t);
+
+  class tag_t {
+  public:
+    tag_t (const char *t) : _old (set_tag (t)) {}
+    ~tag_t () { set_tag (_old); }
+  private:
+    const char *_old;
+  };
+
+  //
+  // Accept control commands on a Unix socket, one per connection:
+  // start, stop, reset, interval <us>, real <0|1>, status, folded,
+  // pprof, report, and memstat and memsample <bytes> (see memtag.h).
+  // init() does this for $SFS_PROFILER_SOCK.
+  //
+  static bool listen (const str &path);
 };
 
 //
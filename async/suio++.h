@@ -26,6 +26,7 @@
 #define _ASYNC_SUIOXX_H_ 1
 
 #include "opnew.h"
+#include "memtag.h"
 #include "vec.h"
 #include "callback.h"
 
@@ -45,6 +46,8 @@ size_t iovsize (const iovec *, int);
 
 class str;
 
+extern memtag suio_memtag;
+
 class suio {
 public:
   enum { smallbufsize = 0x80 };
@@ -87,8 +90,10 @@ protected:
 
   char defbuf[smallbufsize];
 
-  static void *default_allocator (size_t n) { return txmalloc (n); }
-  static void default_deallocator (void *p, size_t) { xfree (p); }
+  static void *default_allocator (size_t n)
+    { return xmalloc_tag (suio_memtag, n); }
+  static void default_deallocator (void *p, size_t n)
+    { xfree_tag (suio_memtag, p, n); }
 
   void makeuiocbs ();
   char *morescratch (size_t);
@@ -0,0 +1,110 @@
+#!/usr/bin/env python
+
+"""Symbolize the folded stacks that the SFS profiler emits in stack
+mode (the ``folded'' control command, or sfs_profiler::dump_folded).
+Frames come out of the process as <object>+0x<offset>; this script
+replaces each one with its function name, using addr2line, so the
+result can be fed straight into flamegraph.pl."""
+
+import sys
+import subprocess
+import re
+import getopt
+
+##=======================================================================
+
+frame_rxx = re.compile (r"^(.+)\+0x([0-9a-fA-F]+)$")
+
+##=======================================================================
+
+def usage (err = None):
+    if err:
+        sys.stderr.write ("%s: %s\n" % (sys.argv[0], err))
+    sys.stderr.write ("usage: %s [-a] [-j <jail>] [<file>]\n"
+                      "  -a   keep object+offset next to the name\n"
+                      "  -j   look for objects under <jail>\n"
+                      % sys.argv[0])
+    sys.exit (2)
+
+##=======================================================================
+
+def symbolize (obj, offs, jail):
+    """Returns a dict from offset to function name for one object."""
+    path = obj
+    if jail:
+        path = jail + "/" + obj
+    try:
+        p = subprocess.Popen (["addr2line", "-f", "-C", "-e", path],
+                              stdin = subprocess.PIPE,
+                              stdout = subprocess.PIPE,
+                              universal_newlines = True)
+    except OSError as e:
+        sys.stderr.write ("addr2line: %s\n" % e)
+        return {}
+    offs = sorted (offs)
+    out, err = p.communicate ("".join (["0x%x\n" % o for o in offs]))
+    lines = out.split ("\n")
+    ret = {}
+    for i, o in enumerate (offs):
+        if 2 * i < len (lines) and lines[2 * i] not in ("", "??"):
+            ret[o] = lines[2 * i]
+    return ret
+
+##=======================================================================
+
+def main (argv):
+    try:
+        opts, args = getopt.getopt (argv[1:], "aj:h")
+    except getopt.GetoptError as e:
+        usage (str (e))
+
+    keep = False
+    jail = None
+    for o, a in opts:
+        if o == "-a":
+            keep = True
+        elif o == "-j":
+            jail = a
+        else:
+            usage ()
+    if len (args) > 1:
+        usage ("too many arguments")
+
+    f = sys.stdin
+    if args:
+        f = open (args[0])
+    stacks = []
+    want = {}
+    for line in f:
+        line = line.rstrip ("\n")
+        if not line:
+            continue
+        frames, count = line.rsplit (" ", 1)
+        frames = frames.split (";")
+        for fr in frames:
+            m = frame_rxx.match (fr)
+            if m:
+                want.setdefault (m.group (1), set ()).add (int (m.group (2), 16))
+        stacks.append ((frames, count))
+
+    names = {}
+    for obj, offs in want.items ():
+        names[obj] = symbolize (obj, offs, jail)
+
+    for frames, count in stacks:
+        out = []
+        for fr in frames:
+            m = frame_rxx.match (fr)
+            if m:
+                nm = names[m.group (1)].get (int (m.group (2), 16))
+                if nm and keep:
+                    fr = "%s [%s]" % (nm, fr)
+                elif nm:
+                    fr = nm
+            out.append (fr.replace (";", ":").replace (" ", "_"))
+        sys.stdout.write ("%s %s\n" % (";".join (out), count))
+
+##=======================================================================
+
+if __name__ == "__main__":
+    main (sys.argv)
@@ -0,0 +1,79 @@
+// -*-c++-*-
+/* $Id$ */
+
+#ifndef _AESPRNG_H_
+#define _AESPRNG_H_ 1
+
+#include "aes.h"
+#include "prng.h"
+
+/*
+ * A buffered generator for callers that draw lots of small random
+ * values (XIDs, nonces, padding).  prng runs a full SHA-1 compression
+ * for every 20 bytes it returns.  This runs AES-128 in counter mode
+ * and hands out a kilobyte-sized buffer, so a word costs a memcpy.
+ *
+ * It uses "fast key erasure": each refill first encrypts one
+ * counter block to make the next key and throws the old key away.
+ * Each byte is also wiped from the buffer as it is handed out.  So
+ * capturing the state later reveals nothing about earlier output.
+ *
+ * The key comes from rnd, and is replaced from rnd whenever
+ * random_update stirs in new entropy, or after afork.  A child
+ * started with a bare fork() must call reseed() itself, or it will
+ * repeat whatever the parent had buffered.
+ *
+ * The state is not locked.  A program with several threads should
+ * give each one its own aesprng rather than share frnd.
+ */
+class aesprng {
+  enum { blocksize = 16, keysize = 16, nblocks = 64 };
+  enum { bufsize = nblocks * blocksize };
+
+  static u_int64_t epoch;
+
+  aes_e ctx;
+  u_char buf[bufsize];
+  size_t pos;			// Bytes of buf already handed out
+  u_int64_t _epoch;
+  u_int _afork_gen;
+  pid_t pid;
+
+  bool stale () const { return _epoch != epoch || _afork_gen != afork_gen; }
+  void gen (u_char *dst, size_t n);
+  void rekey ();
+  void refill ();
+
+public:
+  aesprng () : pos (bufsize), _epoch (0), _afork_gen (0), pid (-1) {}
+  ~aesprng () { bzero (buf, sizeof (buf)); }
+
+  /* Forces every aesprng to take a new key from rnd before its next
+   * output.  random_update calls this. */
+  static void newepoch () { epoch++; }
+
+  void reseed ();
+  void getbytes (void *buf, size_t len);
+  u_int32_t getword () {
+    u_int32_t ret;
+    if (pos + sizeof (ret) > bufsize || stale ())
+      refill ();
+    memcpy (&ret, buf + pos, sizeof (ret));
+    bzero (buf + pos, sizeof (ret));
+    pos += sizeof (ret);
+    return ret;
+  }
+  u_int64_t gethyper () {
+    u_int64_t ret;
+    if (pos + sizeof (ret) > bufsize || stale ())
+      refill ();
+    memcpy (&ret, buf + pos, sizeof (ret));
+    bzero (buf + pos, sizeof (ret));
+    pos += sizeof (ret);
+    return ret;
+  }
+};
+
+extern aesprng frnd;
+
+#endif /* !_AESPRNG_H_ */
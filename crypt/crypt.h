@@ -32,6 +32,7 @@
 
 #include "prng.h"
 extern prng rnd;
+#include "aesprng.h"
 
 #include "rabin.h"
 #include "rsa.h"
@@ -82,7 +82,8 @@ protected:
 
 public:
   esign_priv (const bigint &p, const bigint &q, u_long k);
-  void precompute () const;
+  void precompute () const { precompute (1); }
+  void precompute (size_t cnt) const;
   size_t nprecomputed () const { return prevec.size (); }
   bigint raw_sign (const bigint &m) const;
   bigint sign (const str &msg) const {
@@ -0,0 +1,110 @@
+// -*-c++-*-
+/* $Id$ */
+
+#ifndef _GEAR_FPRINT_H_
+#define _GEAR_FPRINT_H_
+
+// Content-defined chunking with a "gear" rolling hash:
+//
+//   h = (h << 1) + G[byte]
+//
+// where G is a fixed table of random 64-bit values.  Each step is a
+// shift, an add and one table lookup, against the two lookups and
+// the window buffer that window::slide8 needs, and only the last 64
+// bytes influence h.  A breakmark is declared when the bits of h
+// selected by a mask are all zero.  We test the high bits of h,
+// since those depend on the most bytes.
+//
+// Chunk sizes are normalized as in FastCDC: until a chunk reaches the
+// target average size a mask with one extra bit is used (making a
+// breakmark half as likely), and afterwards a mask with one fewer
+// bit.  No breakmark is ever declared before the minimum size, and
+// the hash is only computed for the last 64 bytes leading up to it,
+// so that stretch of every chunk is skipped entirely.
+//
+// Like rabin_fprint, the state carries over between calls, so a
+// stream can be fed in pieces of any size and will be split at the
+// same places as if it were fed all at once.
+
+#include "async.h"
+#include "fprint.h"
+#include "sha1.h"
+
+class gear_fprint : public fprint {
+public:
+  enum { hashwin = 64 };	// Bytes that influence h
+
+  static void initG ();
+
+private:
+  static u_int64_t G[256];
+
+  const size_t _min_size;
+  const size_t _avg_size;
+  const size_t _max_size;
+  u_int64_t _mask_s;		// Before _avg_size
+  u_int64_t _mask_l;		// After _avg_size
+
+  u_int64_t _h;
+  size_t _cs;			// Bytes so far in current chunk
+
+public:
+  gear_fprint (size_t min_size = 2048, size_t avg_size = 8192,
+	       size_t max_size = 65535);
+
+  size_t min_size () const { return _min_size; }
+  size_t avg_size () const { return _avg_size; }
+  size_t max_size () const { return _max_size; }
+
+  /* Scan at most len bytes.  Returns the number of bytes up to and
+   * including the end of the current chunk, or len if the chunk
+   * doesn't end in this buffer.  *brk is set accordingly. */
+  size_t scan (const u_char *data, size_t len, bool *brk);
+
+  void stop () { _h = 0; _cs = 0; }
+  ptr<vec<unsigned int> > chunk_data (const unsigned char *data,
+				      size_t size);
+  ptr<vec<unsigned int> > chunk_data (suio *in_data);
+};
+
+/*
+ * Splits a stream into content-defined chunks and computes the SHA-1
+ * hash of each one.  Feed data with update; call final at the end of
+ * the stream to close the last, short chunk.
+ */
+class cdc_hasher {
+public:
+  struct chunk {
+    u_int64_t off;
+    size_t len;
+    char hash[sha1::hashsize];
+  };
+
+private:
+  gear_fprint _fp;
+  sha1ctx _sc;
+  u_int64_t _off;
+  size_t _len;
+  vec<chunk> _chunks;
+
+  void endchunk ();
+
+public:
+  cdc_hasher (size_t min_size = 2048, size_t avg_size = 8192,
+	      size_t max_size = 65535)
+    : _fp (min_size, avg_size, max_size), _off (0), _len (0) {}
+
+  void update (const void *data, size_t len);
+  void update (const suio *uio);
+  void final ();
+
+  u_int64_t bytes () const { return _off + _len; }
+  vec<chunk> &chunks () { return _chunks; }
+  const vec<chunk> &chunks () const { return _chunks; }
+};
+
+/* Chunk and hash a whole file through mmap.  Returns false and sets
+ * errno if the file cannot be opened or mapped. */
+bool cdc_hash_file (const str &path, cdc_hasher *h);
+
+#endif // _GEAR_FPRINT_H_
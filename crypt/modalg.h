@@ -27,6 +27,7 @@
 #define _MODALG_H_ 1
 
 #include "bigint.h"
+#include "vec.h"
 
 /* On the Pentium II, this sucks; it's slower than mpz_mod. */
 class barrett {
@@ -108,4 +109,41 @@ public:
   }
 };
 
+/* Fixed-base windowed exponentiation.  For a base g that is raised
+ * to many different exponents modulo the same M (e.g., a group
+ * generator), precompute g^(j * 2^(w*i)) for every w-bit window i
+ * and digit j.  g^e then costs one modular multiplication per
+ * non-zero window of e and no squarings.  Exponents longer than the
+ * table fall back to ordinary powm.
+ */
+class fbexp {
+  bigint m;			// Modulus, M
+  bigint g;			// Fixed base
+  u_int w;			// Window width in bits
+  u_int nwin;			// Number of windows in table
+  vec<bigint> tab;		// tab[(i << w) + j] = g^(j * 2^(w*i)) % M
+
+  static void sexp (MP_INT *r, const fbexp *t, const MP_INT *e)
+    { t->mpz_powm (r, e); }
+
+public:
+  enum { defwidth = 4 };
+
+  fbexp () : w (0), nwin (0) {}
+  fbexp (const bigint &gg, const bigint &mm, u_int maxbits,
+	 u_int ww = defwidth)
+    { set (gg, mm, maxbits, ww); }
+  void set (const bigint &g, const bigint &m, u_int maxbits,
+	    u_int w = defwidth);
+
+  const bigint &base () const { return g; }
+  const bigint &modulus () const { return m; }
+  u_int maxbits () const { return w * nwin; }
+
+  /* Fixed-base exponentiation, returns (g^e) % M */
+  void mpz_powm (MP_INT *r, const MP_INT *e) const;
+  mpdelayed<const fbexp *, const MP_INT *> powm (const bigint &e) const
+    { return mpdelayed<const fbexp *, const MP_INT *> (sexp, this, &e); }
+};
+
 #endif /* _MODALG_H_ */
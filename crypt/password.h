@@ -26,6 +26,7 @@
 #define _SFSCRYPT_PASSWORD_H_ 1
 
 #include "str.h"
+#include "amisc.h"
 
 str pw_armorsalt (u_int cost, str bsalt, str ptext = "");
 bool pw_dearmorsalt (u_int *costp, str *bsaltp, str *ptextp, str armor);
@@ -38,4 +39,21 @@ str pw_getptext (str salt);
 str pw_crypt (str pwd, str salt, size_t outsize = 0, eksblowfish *eksb = NULL);
 bigint pw_getint (str pwd, str salt, size_t nbits, eksblowfish *eksb = NULL);
 
+/*
+ * The eksblowfish key schedule is deliberately slow (2^cost
+ * iterations), which on a server means a stalled event loop for
+ * every login attempt.  These variants run pw_rawcrypt in a child
+ * process from a chldpool (pw_chldpool () by default) and call cb
+ * with the result, or with NULL on failure.  They return false
+ * without calling cb if the pool is saturated; callers should treat
+ * that as a temporary failure rather than falling back to hashing
+ * synchronously.
+ */
+class chldpool;
+chldpool *pw_chldpool ();
+bool pw_rawcrypt_async (u_int cost, str pwd, str bsalt, str ptext,
+			size_t outsize, cbs cb, chldpool *pool = NULL);
+bool pw_crypt_async (str pwd, str salt, size_t outsize, cbs cb,
+		     chldpool *pool = NULL);
+
 #endif /* !_SFSCRYPT_PASSWORD_H_ */
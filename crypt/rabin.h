@@ -87,6 +87,8 @@ protected:
 
   void init ();
 
+  void blind (bigint *r, bigint *ri, size_t cnt) const;
+  void D2crt (bigint &, const bigint &, int rsel) const;
   void D2 (bigint &, const bigint &, int rsel = 0) const;
 
 public:
@@ -113,6 +115,39 @@ public:
     D2 (m, m, rnd.getword ());
     return m;
   }
+
+  /* Sign msgs[i] into (*sigs)[i].  Equivalent to calling sign on
+   * each message, but the blinding factors for the whole batch are
+   * inverted with a single modular inversion. */
+  void batch_sign (vec<bigint> *sigs, const vec<str> &msgs) const;
+};
+
+/*
+ * Batch interface to Rabin signature verification, matching
+ * schnorr_batch.  The signature padding is randomized, so the padded
+ * value can only be recovered by squaring each signature; there is no
+ * cheaper combined equation to check.  Each verification is a single
+ * modular squaring, which is already cheap.  The public keys passed
+ * to add must remain valid until verify returns.
+ */
+class rabin_batch {
+  struct sigent {
+    const rabin_pub *pk;
+    str msg;
+    bigint sig;
+  };
+  vec<sigent> sigs;
+
+public:
+  void add (const rabin_pub *pk, const str &msg, const bigint &sig) {
+    sigent &se = sigs.push_back ();
+    se.pk = pk;
+    se.msg = msg;
+    se.sig = sig;
+  }
+  size_t size () const { return sigs.size (); }
+  void clear () { sigs.clear (); }
+  bool verify (vec<bool> *res = NULL) const;
 };
 
 rabin_priv rabin_keygen (size_t nbits, u_int iter = 32);
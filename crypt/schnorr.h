@@ -8,6 +8,7 @@
 
 #include "crypt.h"
 #include "bigint.h"
+#include "modalg.h"
 #include "sha1.h"
 
 
@@ -24,12 +25,23 @@ public:
 };
 
 class schnorr_pub {
+  friend class schnorr_batch;
+
 protected:
   const bigint p;
   const bigint q;
   const bigint g;
   const bigint y;
 
+  /* Fixed-base table for g, built the first time it is needed */
+  mutable ptr<fbexp> gtab;
+
+  const fbexp &gexp () const {
+    if (!gtab)
+      gtab = New refcounted<fbexp> (g, p, q.nbits ());
+    return *gtab;
+  }
+
 protected:
   bool is_group_elem (const bigint &elem) const
   { return powm (elem, q, p) == 1; }
@@ -38,13 +50,13 @@ protected:
   { assert (log != NULL); *log = random_bigint (q.nbits () - 1); }
 
   void elem_from_log (bigint *elem, const bigint &log) const
-  { assert (elem != NULL); *elem = powm (g, log, p); }
+  { assert (elem != NULL); *elem = gexp ().powm (log); }
 
   void bind_r_to_m (bigint *e, const str &m, const bigint &r) const;
 
   bool check_signature (const bigint &r, const bigint &s,
 			const bigint &e, const bigint &y_v) const {
-    bigint gs (powm (g, s, p)), 
+    bigint gs (gexp ().powm (s)), 
            ye (powm (y_v, e, p));
     bigint should_be_gs (r * ye);
 
@@ -131,14 +143,72 @@ class schnorr_priv : public schnorr_pub {
 public:
   schnorr_priv (const bigint &pp, const bigint &qq, const bigint &gg,
 		const bigint &yy, const bigint &xx) 
-    : schnorr_pub (pp, qq, gg, yy), x (xx), ekp (make_ephem_key_pair ()) {}
+    : schnorr_pub (pp, qq, gg, yy), x (xx), npool (1), refilling (false)
+    { ekpool.push_back (make_ephem_key_pair ()); }
 
   bool sign (bigint *r, bigint *s, const str &msg);
   const bigint private_share () const { return x; }
+
+  /* Keep up to n ephemeral key pairs computed ahead of time.  The
+   * pool is topped up one pair per trip through the event loop, so
+   * a burst of signatures only pays for the exponentiations that the
+   * pool could not absorb. */
+  void set_pool_size (u_int n) { npool = max<u_int> (n, 1); refill (); }
+  size_t npooled () const { return ekpool.size (); }
 private:
   const bigint x;
+  u_int npool;
+  bool refilling;
+  vec<ref<ephem_key_pair> > ekpool;
+  void refill ();
   void make_ekp ();
-  ptr<ephem_key_pair> ekp;
+};
+
+/*
+ * Batch verification of Schnorr signatures.  Signatures are grouped
+ * by public key, and each group is checked with a single randomized
+ * equation:
+ *
+ *     g^(sum d_i s_i) == (prod r_i^d_i) * y^(sum d_i e_i)  (mod p)
+ *
+ * where the d_i are fresh random nrbits-bit multipliers, so a forged
+ * signature slips through with probability about 2^-nrbits.  The
+ * r_i^d_i share one chain of squarings.  When a group fails, it is
+ * split in half and each half rechecked, so one bad signature does
+ * not force the whole batch back to individual verification.  This
+ * pays off when nearly all signatures are good; a batch with many bad
+ * signatures can cost more than checking them one at a time.  Every
+ * r_i must still pass the subgroup test individually.
+ *
+ * The public keys passed to add must remain valid until verify
+ * returns.
+ */
+class schnorr_batch {
+  struct sigent {
+    const schnorr_pub *pk;
+    str msg;
+    bigint r;
+    bigint s;
+    bigint e;
+    bool ok;
+  };
+  vec<sigent> sigs;
+
+  static bool samekey (const schnorr_pub *a, const schnorr_pub *b);
+  void check (sigent **v, size_t n);
+
+public:
+  enum { nrbits = 64 };		// Bits in each random multiplier
+  enum { minbatch = 4 };	// Smaller groups are checked one by one
+
+  void add (const schnorr_pub *pk, const str &msg,
+	    const bigint &r, const bigint &s);
+  size_t size () const { return sigs.size (); }
+  void clear () { sigs.clear (); }
+
+  /* Returns true if every signature verified.  If res is non-NULL,
+   * (*res)[i] is set to the outcome for the ith signature added. */
+  bool verify (vec<bool> *res = NULL);
 };
 
 /* 
@@ -25,6 +25,7 @@
 #ifndef _SRP_H_
 #define _SRP_H_ 1
 
+#include "callback.h"
 #include "bigint.h"
 #include "sha1.h"
 #include "blowfish.h"
@@ -33,6 +34,8 @@ typedef rpc_opaque<20> srp_hash;
 typedef rpc_bytes<RPC_INFINITY> srpmsg;
 
 enum srpres { SRP_FAIL, SRP_NEXT, SRP_SETPWD, SRP_LAST, SRP_DONE };
+typedef callback<void, srpres>::ref cbsrpres;
+class chldpool;
 
 class srp_base {
 protected:
@@ -109,6 +112,8 @@ class srp_server : public srp_base {
 
   srpres phase2 (srpmsg *msgout, const srpmsg *msgin);
   srpres phase4 (srpmsg *msgout, const srpmsg *msgin);
+  void phase2_cb (srpmsg *msgout, cbsrpres cb, str res);
+  void phase4_cb (srpmsg *msgout, srp_hash m, cbsrpres cb, str res);
 
 public:
   srp_server () : phase (-1) {}
@@ -116,6 +121,14 @@ public:
 	       const srp_hash &sessid, str user, str info, int version = 6);
   srpres next (srpmsg *msgout, const srpmsg *msgin);
 
+  /* Like next, but the modular exponentiations run in a child from
+   * pool (pw_chldpool () by default), so the event loop isn't held
+   * up by them.  Returns false, without calling cb, if the pool is
+   * saturated.  msgout and the srp_server must stay around until cb
+   * is called. */
+  bool next_async (srpmsg *msgout, const srpmsg *msgin, cbsrpres cb,
+		   chldpool *pool = NULL);
+
   static bool sane (str info);
 };
 
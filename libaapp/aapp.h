@@ -45,7 +45,7 @@ namespace sfs {
     accept_acceptor_t (bool verbose, size_t ps);
     ~accept_acceptor_t ();
 
-    enum { qlen = 200 };
+    enum { qlen = 200, maxaccept = 64 };
   protected:
     void run_impl ();
     void accept ();
@@ -65,12 +65,17 @@ namespace sfs {
     ~net_acceptor_t ();
     bool init ();
 
+    // Bind with SO_REUSEPORT, so that several processes, each with
+    // its own acceptor, can share the port.  Call before init.
+    void set_reuseport (bool b) { _reuseport = b; }
+
   protected:
     void inaddr_from_env ();
     str addr_s () const;
   private:
     port_t _port;
     ip4_addr_t _addr;
+    bool _reuseport;
   };
 
   //-----------------------------------------------------------------------
@@ -34,6 +34,9 @@
  * can call open/read/lseek/fstat and close on it.  Other features
  * may be added in the future.
  *
+ * Call stream() before open to read through an aiostream (see
+ * aiod.h), which reads ahead once it sees sequential access.
+ *
  */
 namespace tame {
 
@@ -42,13 +45,17 @@ namespace tame {
 
   class aiofh_t {
   public:
-    aiofh_t (aiod *a) : _aiod (a), _off (0) {}
+    aiofh_t (aiod *a) : _aiod (a), _off (0), _sblksize (0), _sdepth (0) {}
     ~aiofh_t ();
     void open (const str &fn, int flg, int mode, evi_t ev, CLOSURE);
     void read (size_t sz, aio_read_ev_t ev, CLOSURE);
     void lseek (off_t o) { _off = o; }
     void fstat (aio_stat_ev_t ev) { _fh->fstat (ev); }
     void close (evi_t::ptr ev = NULL, CLOSURE);
+    void stream (size_t blksize = 0x10000, u_int depth = 4)
+    { _sblksize = blksize; _sdepth = depth; }
+    const aiostream_stats *stream_stats () const
+    { return _stream ? &_stream->getstats () : NULL; }
 
   private:
     aiod *_aiod;
@@ -57,6 +64,9 @@ namespace tame {
     size_t _bufsz;
     off_t _off;
     str _fn;
+    size_t _sblksize;
+    u_int _sdepth;
+    ptr<aiostream> _stream;
   };
 
   typedef event<ptr<aiofh_t> >::ref open_ev_t;
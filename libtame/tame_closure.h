@@ -29,6 +29,7 @@
 #include "tame_event.h"
 #include "tame_run.h"
 #include "tame_weakref.h"
+#include "sfs_profiler.h"
 
 
 // All closures are numbered serially so that our accounting does not
@@ -114,6 +115,23 @@ private:
 
 typedef ptr<closure_t> closure_ptr_t;
 
+#if REFCNT_CLASS_ALLOC
+/* Closures are charged, by their full size, to the "tame" memtag */
+extern memtag closure_memtag;
+inline void *
+refcount_alloc (const closure_t *, size_t n)
+{
+  closure_memtag.alloc (n);
+  return ::operator new (n);
+}
+inline void
+refcount_free (const closure_t *, void *p, size_t n)
+{
+  closure_memtag.dealloc (n);
+  ::operator delete (p);
+}
+#endif /* REFCNT_CLASS_ALLOC */
+
 template<class C>
 class closure_action 
 #ifdef TAME_DETEMPLATIZE
@@ -159,6 +177,8 @@ private:
     ptr<C> c = _closure;
     _closure = NULL;
     if (c->block_dec_count (loc)) {
+      // Charge profiler samples taken until we block again to c
+      sfs_profiler::tag_t t (c->funcname ());
       if (tame_always_virtual ()) {
 	c->v_reenter ();
       } else {
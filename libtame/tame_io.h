@@ -161,6 +161,33 @@ namespace tame {
     suio _buf;
   };
 
+  //
+  // Moves data with splice(2) through a pipe, so it never enters user
+  // space.  setup() must be called with the fds before go(); if splice
+  // cannot work with them, or later fails with EINVAL, the proxy
+  // behaves just like std_proxy_t.
+  //
+  class splice_proxy_t : public std_proxy_t {
+  public:
+    splice_proxy_t (const str &d = NULL, ssize_t sz = -1);
+    virtual ~splice_proxy_t ();
+    bool setup (int infd, int outfd);
+    bool spliced () const { return _splice; }
+
+  protected:
+    virtual bool is_readable () const;
+    virtual bool is_writable () const;
+    virtual int v_read (int fd);
+    virtual int v_write (int fd);
+
+    void fallback ();
+
+    bool _splice;
+    bool _full;		// The last splice in found no room in the pipe
+    size_t _inpipe;
+    int _pipe[2];
+  };
+
   void proxy (int in, int out, evv_t cb, CLOSURE);
 
   //-----------------------------------------------------------------------
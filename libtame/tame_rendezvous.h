@@ -312,6 +312,7 @@ public:
       ptr<closure_t> c = _join_cls;
       _join_cls = NULL;
       _join_method = JOIN_NONE;
+      sfs_profiler::tag_t t (c->funcname ());
       c->v_reenter ();
     } else if (_join_method == JOIN_THREADS) {
 #ifdef HAVE_TAME_PTH
@@ -29,6 +29,7 @@
 #include "async.h"
 #include "arpc.h"
 #include "tame.h"
+#include "qhash.h"
 
 //
 // Tame library functions: wrappers around typical Unix I/O.
@@ -47,24 +48,76 @@ namespace tame {
     virtual ~server_t () {}
     virtual void dispatch (svccb *svp) = 0;
     virtual const rpc_program &get_prog () const = 0;
-    void runloop (CLOSURE);
+    void runloop (evv_t::ptr done = NULL, CLOSURE);
   private:
     ptr<axprt_stream> _x;
     int _verbosity;
   };
 
+  //
+  // By default, run accepts and serves every connection in this
+  // process.  With set_workers (n) and set_argv, it instead runs the
+  // program n more times as worker processes that accept on the
+  // port, and itself only watches over them, starting a new one when
+  // one dies.  A worker's call to run knows it is one by TAME_WORKER
+  // in its environment, and serves.  The workers share the listening
+  // socket, or with set_reuseport, each binds its own and the kernel
+  // spreads connections over them.
+  //
+  // SIGHUP starts a new generation of workers, then has the old ones
+  // stop accepting and exit once their connections close (or after
+  // set_drain_wait seconds).  SIGUSR2 does the same for the whole
+  // server: given set_argv, it runs the program again, handing over
+  // the listening socket in TAME_LISTEN_FD, and drains this one.
+  // Either way, the old processes stop accepting only once the new
+  // ones say they are, on a pipe passed in TAME_READY_FD, so the port
+  // never stops accepting; open connections are left to finish.  SIGINT and SIGTERM drain and stop
+  // everything, and a second one kills the workers at once.  Workers
+  // ignore SIGINT, SIGHUP and SIGUSR2, which a terminal may send the
+  // whole process group, and drain on their supervisor's SIGTERM.
+  //
   class server_factory_t {
   public:
-    server_factory_t () : _verbosity (VERB_LOW) {}
+    server_factory_t () 
+      : _verbosity (VERB_LOW), _nworkers (0), _reuseport (false),
+	_drain_wait (60), _worker (false), _readyfd (-1), _gen (0),
+	_nlive (0) {}
     virtual ~server_factory_t () {}
     virtual server_t *alloc_server (int fd, int v) = 0;
-    void new_connection (int fd);
+    bool new_connection (int fd);
     void run (const str &port, evb_t done);
     void run (u_int port, evb_t done) { run_T (port, done); }
     void set_verbosity (int i) { _verbosity = i; }
+    void set_workers (u_int n) { _nworkers = n; }
+    void set_reuseport (bool b) { _reuseport = b; }
+    void set_drain_wait (time_t t) { _drain_wait = t; }
+    void set_argv (char *const *argv);
+    u_int nlive () const { return _nlive; }
   private:
     void run_T (u_int port, evb_t done, CLOSURE);
+    void serve (int fd, evv_t done, CLOSURE);
+    void serve1 (server_t *srv, CLOSURE);
+    void drain (evv_t done, CLOSURE);
+    void supervise (int fd, evv_t done, CLOSURE);
+    pid_t spawn_self (int fd, bool worker, int *readyp);
+    void report_ready ();
+    u_int count (u_int gen) const;
+    void retire (u_int gen);
+    void kill_all ();
+    void reexec (int fd, evb_t done, CLOSURE);
+    int listen_socket (u_int port);
+
     int _verbosity;
+    u_int _nworkers;
+    bool _reuseport;
+    time_t _drain_wait;
+    vec<str> _argv;
+    bool _worker;		// True in a worker process
+    int _readyfd;		// To tell our starter we are accepting
+    u_int _gen;			// Generation of workers now wanted
+    qhash<pid_t, u_int> _pids;	// Running workers, by generation
+    u_int _nlive;		// Connections being served
+    evv_t::ptr _idle;		// Triggered when _nlive reaches 0
   };
 
 };
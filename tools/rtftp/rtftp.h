@@ -3,7 +3,92 @@
 
 #include "async.h"
 #include "rtftp_prot.h"
+#include "gear_fprint.h"
+#include "qhash.h"
 
 bool check_file (const rtftp_file_t &f);
 int write_file (const str &nm, const str &dat, bool do_fsync = false);
 int open_file (const str &nm, int d);
+int make_parents (const str &nm);
+u_int64_t now_usec ();
+
+// How much of a striped transfer may arrive ahead of a missing chunk
+enum { RTFTP_MAX_HELD = 0x4000000 };
+
+//
+// SHA-1 of data that may arrive out of order, as when a transfer is
+// striped over several connections.  Pieces past the next offset
+// wanted are held, up to max_held bytes, until the gap before them
+// fills; update fails on a piece it cannot take.
+//
+class ordered_hash_t {
+public:
+  ordered_hash_t (size_t max_held) 
+    : _pos (0), _max_held (max_held), _held_bytes (0) {}
+  bool update (u_int64_t off, const char *p, size_t len);
+  u_int64_t pos () const { return _pos; }
+  size_t held () const { return _held_bytes; }
+  void final (char *buf) { _ctx.final (buf); }
+private:
+  sha1ctx _ctx;
+  u_int64_t _pos;
+  const size_t _max_held;
+  size_t _held_bytes;
+  qhash<u_int64_t, str> _held;
+};
+
+//-----------------------------------------------------------------------
+//
+// Version 3 transfers: chunk manifests.  A file is stored with its
+// manifest in <file>.rtftp_mf; while a transfer is under way, the new
+// data goes to <file>.rtftp_part and its manifest to
+// <file>.rtftp_pmf, so that an interrupted transfer can pick up
+// where it left off.
+//
+
+#define RTFTP_MANIFEST_SFX ".rtftp_mf"
+#define RTFTP_PART_SFX ".rtftp_part"
+#define RTFTP_PART_MANIFEST_SFX ".rtftp_pmf"
+
+//
+// Splits data fed to it into chunks as c says, hashing each chunk
+// and the whole.
+//
+class manifest_builder_t {
+public:
+  manifest_builder_t (const rtftp_chunking_t &c);
+  void update (const char *p, size_t len);
+  void final (rtftp_manifest_t *m);
+private:
+  void endchunk ();
+
+  const rtftp_chunking_t _chunking;
+  ptr<cdc_hasher> _cdc;
+  sha1ctx _file_ctx;
+  sha1ctx _chunk_ctx;
+  u_int64_t _off;
+  size_t _len;
+  vec<rtftp_chunk_hash_t> _chunks;
+};
+
+void default_chunking (rtftp_chunking_t *c, bool cdc, size_t sz);
+bool check_chunking (const rtftp_chunking_t &c);
+bool check_manifest (const rtftp_manifest_t &m);
+bool check_chunk (const rtftp_chunk_hash_t &c, const void *p, size_t len);
+bool same_manifest (const rtftp_manifest_t &a, const rtftp_manifest_t &b);
+
+// Builds the manifest of an open file's contents from off on.  With
+// nthreads > 1, fixed-size chunks are hashed on that many threads
+// while this one computes the hash of the whole.
+bool manifest_fd (int fd, off_t off, const rtftp_chunking_t &c, 
+		  rtftp_manifest_t *m, u_int nthreads = 1);
+
+// Chunk hash to the first chunk in a manifest with it, for finding
+// chunks one already has.
+typedef qhash<str, u_int32_t> chunk_index_t;
+inline str 
+chunk_key (const rtftp_hash_t &h) 
+{ 
+  return str (h.base (), h.size ()); 
+}
+void index_manifest (const rtftp_manifest_t &m, chunk_index_t *ix);
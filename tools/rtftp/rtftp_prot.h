@@ -204,6 +204,103 @@ rpc_traverse (T &t, rtftp_footer_t &obj, const char *field = NULL)
 }
 
 
+enum rtftp_chunking_typ_t {
+  RTFTP_CHUNK_FIXED = 0,
+  RTFTP_CHUNK_CDC = 1,
+};
+void *rtftp_chunking_typ_t_alloc ();
+bool_t xdr_rtftp_chunking_typ_t (XDR *, void *);
+RPC_ENUM_DECL (rtftp_chunking_typ_t)
+TYPE2STRUCT( , rtftp_chunking_typ_t);
+
+template<class T> inline bool
+rpc_traverse (T &t, rtftp_chunking_typ_t &obj, const char *field = NULL)
+{
+  u_int32_t val = obj;
+  bool ret = true;
+  rpc_enter_field (t, field);
+  if (!rpc_traverse (t, val)) {
+    ret = false;
+  } else {
+    obj = rtftp_chunking_typ_t (val);
+  }
+  rpc_exit_field (t, field);
+  return ret;
+}
+
+
+struct rtftp_chunking_t {
+  rtftp_chunking_typ_t typ;
+  u_int32_t min_size;
+  u_int32_t avg_size;
+  u_int32_t max_size;
+};
+void *rtftp_chunking_t_alloc ();
+bool_t xdr_rtftp_chunking_t (XDR *, void *);
+RPC_STRUCT_DECL (rtftp_chunking_t)
+
+template<class T> bool
+rpc_traverse (T &t, rtftp_chunking_t &obj, const char *field = NULL)
+{
+  bool ret = true;
+  rpc_enter_field (t, field);
+  ret = rpc_traverse (t, obj.typ, "typ")
+    && rpc_traverse (t, obj.min_size, "min_size")
+    && rpc_traverse (t, obj.avg_size, "avg_size")
+    && rpc_traverse (t, obj.max_size, "max_size");
+  rpc_exit_field (t, field);
+  return ret;
+}
+
+
+
+struct rtftp_chunk_hash_t {
+  u_int32_t offset;
+  u_int32_t size;
+  rtftp_hash_t hash;
+};
+void *rtftp_chunk_hash_t_alloc ();
+bool_t xdr_rtftp_chunk_hash_t (XDR *, void *);
+RPC_STRUCT_DECL (rtftp_chunk_hash_t)
+
+template<class T> bool
+rpc_traverse (T &t, rtftp_chunk_hash_t &obj, const char *field = NULL)
+{
+  bool ret = true;
+  rpc_enter_field (t, field);
+  ret = rpc_traverse (t, obj.offset, "offset")
+    && rpc_traverse (t, obj.size, "size")
+    && rpc_traverse (t, obj.hash, "hash");
+  rpc_exit_field (t, field);
+  return ret;
+}
+
+
+
+struct rtftp_manifest_t {
+  rtftp_chunking_t chunking;
+  u_int32_t size;
+  rtftp_hash_t hash;
+  rpc_vec<rtftp_chunk_hash_t, RPC_INFINITY> chunks;
+};
+void *rtftp_manifest_t_alloc ();
+bool_t xdr_rtftp_manifest_t (XDR *, void *);
+RPC_STRUCT_DECL (rtftp_manifest_t)
+
+template<class T> bool
+rpc_traverse (T &t, rtftp_manifest_t &obj, const char *field = NULL)
+{
+  bool ret = true;
+  rpc_enter_field (t, field);
+  ret = rpc_traverse (t, obj.chunking, "chunking")
+    && rpc_traverse (t, obj.size, "size")
+    && rpc_traverse (t, obj.hash, "hash")
+    && rpc_traverse (t, obj.chunks, "chunks");
+  rpc_exit_field (t, field);
+  return ret;
+}
+
+
 
 struct rtftp_get_res_t {
   const rtftp_status_t status;
@@ -579,6 +676,236 @@ bool_t xdr_rtftp_get2_res_t (XDR *, void *);
 RPC_UNION_DECL (rtftp_get2_res_t)
 
 
+
+struct rtftp_put3_arg_t {
+  rtftp_id_t name;
+  rtftp_manifest_t manifest;
+};
+void *rtftp_put3_arg_t_alloc ();
+bool_t xdr_rtftp_put3_arg_t (XDR *, void *);
+RPC_STRUCT_DECL (rtftp_put3_arg_t)
+
+template<class T> bool
+rpc_traverse (T &t, rtftp_put3_arg_t &obj, const char *field = NULL)
+{
+  bool ret = true;
+  rpc_enter_field (t, field);
+  ret = rpc_traverse (t, obj.name, "name")
+    && rpc_traverse (t, obj.manifest, "manifest");
+  rpc_exit_field (t, field);
+  return ret;
+}
+
+
+
+struct rtftp_put3_begin_t {
+  rtftp_xfer_id_t xfer_id;
+  rpc_vec<u_int32_t, RPC_INFINITY> need;
+  u_int32_t resumed;
+  u_int32_t deduped;
+};
+void *rtftp_put3_begin_t_alloc ();
+bool_t xdr_rtftp_put3_begin_t (XDR *, void *);
+RPC_STRUCT_DECL (rtftp_put3_begin_t)
+
+template<class T> bool
+rpc_traverse (T &t, rtftp_put3_begin_t &obj, const char *field = NULL)
+{
+  bool ret = true;
+  rpc_enter_field (t, field);
+  ret = rpc_traverse (t, obj.xfer_id, "xfer_id")
+    && rpc_traverse (t, obj.need, "need")
+    && rpc_traverse (t, obj.resumed, "resumed")
+    && rpc_traverse (t, obj.deduped, "deduped");
+  rpc_exit_field (t, field);
+  return ret;
+}
+
+
+
+struct rtftp_put3_res_t {
+  const rtftp_status_t status;
+  union {
+    union_entry_base _base;
+    union_entry<rtftp_put3_begin_t> begin;
+  };
+
+#define rpcunion_tag_rtftp_put3_res_t status
+#define rpcunion_switch_rtftp_put3_res_t(swarg, action, voidaction, defaction) \
+  switch (swarg) { \
+  case RTFTP_BEGIN: \
+    action (rtftp_put3_begin_t, begin); \
+    break; \
+  default: \
+    voidaction; \
+    break; \
+  }
+
+  rtftp_put3_res_t (rtftp_status_t _tag = (rtftp_status_t) 0) : status (_tag)
+    { _base.init (); set_status (_tag); }
+  rtftp_put3_res_t (const rtftp_put3_res_t &_s)
+    : status (_s.status)
+    { _base.init (_s._base); }
+  ~rtftp_put3_res_t () { _base.destroy (); }
+  rtftp_put3_res_t &operator= (const rtftp_put3_res_t &_s) {
+    const_cast<rtftp_status_t &> (status) = _s.status;
+    _base.assign (_s._base);
+    return *this;
+  }
+
+  void set_status (rtftp_status_t _tag) {
+    const_cast<rtftp_status_t &> (status) = _tag;
+    rpcunion_switch_rtftp_put3_res_t
+      (_tag, RPCUNION_SET, _base.destroy (), _base.destroy ());
+  }
+};
+
+template<class T> bool
+rpc_traverse (T &t, rtftp_put3_res_t &obj, const char *field = NULL)
+{
+  bool ret = true;
+  rpc_enter_field (t, field);
+  rtftp_status_t tag = obj.status;
+  if (!rpc_traverse (t, tag, "status")) { 
+    ret = false;
+  } else {
+    if (tag != obj.status)
+      obj.set_status (tag);
+
+    rpcunion_switch_rtftp_put3_res_t
+      (obj.status, ret = RPCUNION_TRAVERSE_2, ret = true, ret = false);
+    /* gcc 4.0.3 makes buggy warnings without the following.. */
+  }
+  rpc_exit_field (t, field);
+  return ret;
+}
+inline bool
+rpc_traverse (const stompcast_t &s, rtftp_put3_res_t &obj, const char *field = NULL)
+{
+  rpcunion_switch_rtftp_put3_res_t
+    (obj.status, RPCUNION_REC_STOMPCAST,
+     obj._base.destroy (); return true, obj._base.destroy (); return true;);
+  /* gcc 4.0.3 makes buggy warnings without the following line */
+  return false;
+}
+void *rtftp_put3_res_t_alloc ();
+bool_t xdr_rtftp_put3_res_t (XDR *, void *);
+RPC_UNION_DECL (rtftp_put3_res_t)
+
+
+
+struct rtftp_get3_arg_t {
+  rtftp_id_t name;
+  rtftp_chunking_t chunking;
+};
+void *rtftp_get3_arg_t_alloc ();
+bool_t xdr_rtftp_get3_arg_t (XDR *, void *);
+RPC_STRUCT_DECL (rtftp_get3_arg_t)
+
+template<class T> bool
+rpc_traverse (T &t, rtftp_get3_arg_t &obj, const char *field = NULL)
+{
+  bool ret = true;
+  rpc_enter_field (t, field);
+  ret = rpc_traverse (t, obj.name, "name")
+    && rpc_traverse (t, obj.chunking, "chunking");
+  rpc_exit_field (t, field);
+  return ret;
+}
+
+
+
+struct rtftp_get3_begin_t {
+  rtftp_xfer_id_t xfer_id;
+  rtftp_manifest_t manifest;
+};
+void *rtftp_get3_begin_t_alloc ();
+bool_t xdr_rtftp_get3_begin_t (XDR *, void *);
+RPC_STRUCT_DECL (rtftp_get3_begin_t)
+
+template<class T> bool
+rpc_traverse (T &t, rtftp_get3_begin_t &obj, const char *field = NULL)
+{
+  bool ret = true;
+  rpc_enter_field (t, field);
+  ret = rpc_traverse (t, obj.xfer_id, "xfer_id")
+    && rpc_traverse (t, obj.manifest, "manifest");
+  rpc_exit_field (t, field);
+  return ret;
+}
+
+
+
+struct rtftp_get3_res_t {
+  const rtftp_status_t status;
+  union {
+    union_entry_base _base;
+    union_entry<rtftp_get3_begin_t> begin;
+  };
+
+#define rpcunion_tag_rtftp_get3_res_t status
+#define rpcunion_switch_rtftp_get3_res_t(swarg, action, voidaction, defaction) \
+  switch (swarg) { \
+  case RTFTP_BEGIN: \
+    action (rtftp_get3_begin_t, begin); \
+    break; \
+  default: \
+    voidaction; \
+    break; \
+  }
+
+  rtftp_get3_res_t (rtftp_status_t _tag = (rtftp_status_t) 0) : status (_tag)
+    { _base.init (); set_status (_tag); }
+  rtftp_get3_res_t (const rtftp_get3_res_t &_s)
+    : status (_s.status)
+    { _base.init (_s._base); }
+  ~rtftp_get3_res_t () { _base.destroy (); }
+  rtftp_get3_res_t &operator= (const rtftp_get3_res_t &_s) {
+    const_cast<rtftp_status_t &> (status) = _s.status;
+    _base.assign (_s._base);
+    return *this;
+  }
+
+  void set_status (rtftp_status_t _tag) {
+    const_cast<rtftp_status_t &> (status) = _tag;
+    rpcunion_switch_rtftp_get3_res_t
+      (_tag, RPCUNION_SET, _base.destroy (), _base.destroy ());
+  }
+};
+
+template<class T> bool
+rpc_traverse (T &t, rtftp_get3_res_t &obj, const char *field = NULL)
+{
+  bool ret = true;
+  rpc_enter_field (t, field);
+  rtftp_status_t tag = obj.status;
+  if (!rpc_traverse (t, tag, "status")) { 
+    ret = false;
+  } else {
+    if (tag != obj.status)
+      obj.set_status (tag);
+
+    rpcunion_switch_rtftp_get3_res_t
+      (obj.status, ret = RPCUNION_TRAVERSE_2, ret = true, ret = false);
+    /* gcc 4.0.3 makes buggy warnings without the following.. */
+  }
+  rpc_exit_field (t, field);
+  return ret;
+}
+inline bool
+rpc_traverse (const stompcast_t &s, rtftp_get3_res_t &obj, const char *field = NULL)
+{
+  rpcunion_switch_rtftp_get3_res_t
+    (obj.status, RPCUNION_REC_STOMPCAST,
+     obj._base.destroy (); return true, obj._base.destroy (); return true;);
+  /* gcc 4.0.3 makes buggy warnings without the following line */
+  return false;
+}
+void *rtftp_get3_res_t_alloc ();
+bool_t xdr_rtftp_get3_res_t (XDR *, void *);
+RPC_UNION_DECL (rtftp_get3_res_t)
+
+
 #ifndef RTFTP_PROGRAM
 #define RTFTP_PROGRAM 5401
 #endif /* !RTFTP_PROGRAM */
@@ -591,6 +918,8 @@ enum {
   RTFTP_GET = 3,
   RTFTP_PUT2 = 4,
   RTFTP_GET2 = 5,
+  RTFTP_PUT3 = 6,
+  RTFTP_GET3 = 7,
 };
 #define RTFTP_PROGRAM_1_APPLY_NOVOID(macro, void) \
   macro (RTFTP_NULL, void, void) \
@@ -598,7 +927,9 @@ enum {
   macro (RTFTP_PUT, rtftp_file_t, rtftp_status_t) \
   macro (RTFTP_GET, rtftp_id_t, rtftp_get_res_t) \
   macro (RTFTP_PUT2, rtftp_put2_arg_t, rtftp_put2_res_t) \
-  macro (RTFTP_GET2, rtftp_get2_arg_t, rtftp_get2_res_t)
+  macro (RTFTP_GET2, rtftp_get2_arg_t, rtftp_get2_res_t) \
+  macro (RTFTP_PUT3, rtftp_put3_arg_t, rtftp_put3_res_t) \
+  macro (RTFTP_GET3, rtftp_get3_arg_t, rtftp_get3_res_t)
 #define RTFTP_PROGRAM_1_APPLY(macro) \
   RTFTP_PROGRAM_1_APPLY_NOVOID(macro, void)
 
@@ -963,6 +1294,132 @@ namespace RPC {
       S *_sbp;
     };
 
+
+    // RTFTP_PUT3 -----------------------------------------
+
+    template<class C, class E> void
+    rtftp_put3(C c, const rtftp_put3_arg_t *arg, rtftp_put3_res_t *res, E cb)
+    { c->call (RTFTP_PUT3, arg, res, cb); }
+
+    template<class C, class E> void
+    rtftp_put3(C c, const rtftp_put3_arg_t &arg, rtftp_put3_res_t *res, E cb)
+    { c->call (RTFTP_PUT3, &arg, res, cb); }
+
+    template<class E> void
+    w_rtftp_put3(typename callback<void,rpc_bundle_t,E>::ref c, const rtftp_put3_arg_t *arg, rtftp_put3_res_t *res, E cb)
+    { (*c) ( rpc_bundle_t (RTFTP_PUT3, arg, res), cb); }
+
+    template<class E> void
+    w_rtftp_put3(typename callback<void,rpc_bundle_t,E>::ref c, const rtftp_put3_arg_t &arg, rtftp_put3_res_t *res, E cb)
+    { (*c) ( rpc_bundle_t (RTFTP_PUT3, &arg, res), cb); }
+
+    template<class R, class E> R
+    w_rtftp_put3(typename callback<R,rpc_bundle_t,E>::ref c, const rtftp_put3_arg_t *arg, rtftp_put3_res_t *res, E cb)
+    { return (*c) ( rpc_bundle_t (RTFTP_PUT3, arg, res), cb); }
+
+    template<class R, class E> R
+    w_rtftp_put3(typename callback<R,rpc_bundle_t,E>::ref c, const rtftp_put3_arg_t &arg, rtftp_put3_res_t *res, E cb)
+    { return (*c) ( rpc_bundle_t (RTFTP_PUT3, &arg, res), cb); }
+
+    template<class S>
+    class rtftp_put3_srv_t {
+    public:
+      rtftp_put3_srv_t(S *s) : _replied (false), _sbp (s) {}
+      const ::rtftp_put3_arg_t* getarg() const {  return static_cast<rtftp_put3_arg_t*> (_sbp->getvoidarg ()); }
+      ::rtftp_put3_arg_t* getarg() {  return static_cast<rtftp_put3_arg_t*> (_sbp->getvoidarg ()); }
+      void reply (const ::rtftp_put3_res_t *r) { check_reply (); _sbp->reply (r); }
+      void reply (const ::rtftp_put3_res_t &r) { check_reply (); _sbp->replyref (r); }
+      void reply (ptr< ::rtftp_put3_res_t> r) { check_reply (); _sbp->reply (r); }
+      ptr<rtftp_put3_res_t> alloc_res ()  { return New refcounted<rtftp_put3_res_t> (); }
+      template<class T> ptr<rtftp_put3_res_t>
+      alloc_res (const T &t)  { return New refcounted<rtftp_put3_res_t> (t); }
+      S *sbp () { return _sbp; }
+      const S *sbp () const { return _sbp; }
+      void reject (auth_stat s) { check_reply (); _sbp->reject (s); }
+      void reject (accept_stat s) { check_reply (); _sbp->reject (s); }
+      void reject () { check_reply (); _sbp->reject (); }
+
+      typedef rtftp_put3_arg_t arg_ty;
+
+      typedef rtftp_put3_res_t res_ty;
+
+      template<class C, class E> void
+      call_full(C c, const rtftp_put3_arg_t *arg, rtftp_put3_res_t *res, E cb)
+      { c->call (RTFTP_PUT3, arg, res, cb); }
+
+      template<class C, class E>
+      void call(C c, const rtftp_put3_arg_t* arg, rtftp_put3_res_t* res, E cb)
+      { rtftp_put3(c, arg, res, cb); }
+
+    private:
+      void check_reply () { assert (!_replied); _replied = true; }
+      bool _replied;
+      S *_sbp;
+    };
+
+
+    // RTFTP_GET3 -----------------------------------------
+
+    template<class C, class E> void
+    rtftp_get3(C c, const rtftp_get3_arg_t *arg, rtftp_get3_res_t *res, E cb)
+    { c->call (RTFTP_GET3, arg, res, cb); }
+
+    template<class C, class E> void
+    rtftp_get3(C c, const rtftp_get3_arg_t &arg, rtftp_get3_res_t *res, E cb)
+    { c->call (RTFTP_GET3, &arg, res, cb); }
+
+    template<class E> void
+    w_rtftp_get3(typename callback<void,rpc_bundle_t,E>::ref c, const rtftp_get3_arg_t *arg, rtftp_get3_res_t *res, E cb)
+    { (*c) ( rpc_bundle_t (RTFTP_GET3, arg, res), cb); }
+
+    template<class E> void
+    w_rtftp_get3(typename callback<void,rpc_bundle_t,E>::ref c, const rtftp_get3_arg_t &arg, rtftp_get3_res_t *res, E cb)
+    { (*c) ( rpc_bundle_t (RTFTP_GET3, &arg, res), cb); }
+
+    template<class R, class E> R
+    w_rtftp_get3(typename callback<R,rpc_bundle_t,E>::ref c, const rtftp_get3_arg_t *arg, rtftp_get3_res_t *res, E cb)
+    { return (*c) ( rpc_bundle_t (RTFTP_GET3, arg, res), cb); }
+
+    template<class R, class E> R
+    w_rtftp_get3(typename callback<R,rpc_bundle_t,E>::ref c, const rtftp_get3_arg_t &arg, rtftp_get3_res_t *res, E cb)
+    { return (*c) ( rpc_bundle_t (RTFTP_GET3, &arg, res), cb); }
+
+    template<class S>
+    class rtftp_get3_srv_t {
+    public:
+      rtftp_get3_srv_t(S *s) : _replied (false), _sbp (s) {}
+      const ::rtftp_get3_arg_t* getarg() const {  return static_cast<rtftp_get3_arg_t*> (_sbp->getvoidarg ()); }
+      ::rtftp_get3_arg_t* getarg() {  return static_cast<rtftp_get3_arg_t*> (_sbp->getvoidarg ()); }
+      void reply (const ::rtftp_get3_res_t *r) { check_reply (); _sbp->reply (r); }
+      void reply (const ::rtftp_get3_res_t &r) { check_reply (); _sbp->replyref (r); }
+      void reply (ptr< ::rtftp_get3_res_t> r) { check_reply (); _sbp->reply (r); }
+      ptr<rtftp_get3_res_t> alloc_res ()  { return New refcounted<rtftp_get3_res_t> (); }
+      template<class T> ptr<rtftp_get3_res_t>
+      alloc_res (const T &t)  { return New refcounted<rtftp_get3_res_t> (t); }
+      S *sbp () { return _sbp; }
+      const S *sbp () const { return _sbp; }
+      void reject (auth_stat s) { check_reply (); _sbp->reject (s); }
+      void reject (accept_stat s) { check_reply (); _sbp->reject (s); }
+      void reject () { check_reply (); _sbp->reject (); }
+
+      typedef rtftp_get3_arg_t arg_ty;
+
+      typedef rtftp_get3_res_t res_ty;
+
+      template<class C, class E> void
+      call_full(C c, const rtftp_get3_arg_t *arg, rtftp_get3_res_t *res, E cb)
+      { c->call (RTFTP_GET3, arg, res, cb); }
+
+      template<class C, class E>
+      void call(C c, const rtftp_get3_arg_t* arg, rtftp_get3_res_t* res, E cb)
+      { rtftp_get3(c, arg, res, cb); }
+
+    private:
+      void check_reply () { assert (!_replied); _replied = true; }
+      bool _replied;
+      S *_sbp;
+    };
+
   };
 };
 
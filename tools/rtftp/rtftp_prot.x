@@ -61,6 +61,38 @@ struct rtftp_footer_t {
        rtftp_hash_t hash;
 };
 
+/*
+ * Version 3 transfers describe a file by a manifest of its chunks'
+ * hashes, so that only the chunks the other side lacks are sent.
+ * Chunk boundaries are either every avg_size bytes, or where the
+ * content says (see gear_fprint.h), so that an insertion early in a
+ * file does not move every boundary after it.
+ */
+enum rtftp_chunking_typ_t {
+     RTFTP_CHUNK_FIXED = 0,
+     RTFTP_CHUNK_CDC = 1
+};
+
+struct rtftp_chunking_t {
+       rtftp_chunking_typ_t typ;
+       unsigned min_size;
+       unsigned avg_size;
+       unsigned max_size;
+};
+
+struct rtftp_chunk_hash_t {
+       unsigned offset;
+       unsigned size;
+       rtftp_hash_t hash;
+};
+
+struct rtftp_manifest_t {
+       rtftp_chunking_t chunking;
+       unsigned size;
+       rtftp_hash_t hash;
+       rtftp_chunk_hash_t chunks<>;
+};
+
 union rtftp_get_res_t switch (rtftp_status_t status) {
 case RTFTP_OK:
        rtftp_file_t file;
@@ -107,6 +139,42 @@ default:
 
 };
 
+struct rtftp_put3_arg_t {
+       rtftp_id_t name;
+       rtftp_manifest_t manifest;
+};
+
+struct rtftp_put3_begin_t {
+       rtftp_xfer_id_t xfer_id;
+       unsigned need<>;		/* indices of the chunks to send */
+       unsigned resumed;	/* bytes kept from an interrupted PUT3 */
+       unsigned deduped;	/* bytes found in the old file */
+};
+
+union rtftp_put3_res_t switch (rtftp_status_t status) {
+case RTFTP_BEGIN:
+     rtftp_put3_begin_t begin;
+default:
+     void;
+};
+
+struct rtftp_get3_arg_t {
+       rtftp_id_t name;
+       rtftp_chunking_t chunking;  /* if the server has no manifest yet */
+};
+
+struct rtftp_get3_begin_t {
+       rtftp_xfer_id_t xfer_id;
+       rtftp_manifest_t manifest;
+};
+
+union rtftp_get3_res_t switch (rtftp_status_t status) {
+case RTFTP_BEGIN:
+     rtftp_get3_begin_t begin;
+default:
+     void;
+};
+
 namespace RPC {
 
 program RTFTP_PROGRAM { 
@@ -130,6 +198,17 @@ program RTFTP_PROGRAM {
 	rtftp_get2_res_t
 	RTFTP_GET2(rtftp_get2_arg_t) = 5;
 
+	/*
+	 * PUT3 and GET3 begin a transfer by manifest.  The chunks and
+	 * the end of the transfer then go through PUT2 and GET2 with
+	 * the xfer_id they return; PUT3 chunks may come in any order.
+	 */
+	rtftp_put3_res_t
+	RTFTP_PUT3(rtftp_put3_arg_t) = 6;
+
+	rtftp_get3_res_t
+	RTFTP_GET3(rtftp_get3_arg_t) = 7;
+
 	} = 1;
 } = 5401;	  
 
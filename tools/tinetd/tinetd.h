@@ -14,6 +14,7 @@
 
 class main_t;
 class child_t;
+class worker_t;
 
 //=======================================================================
 
@@ -21,10 +22,10 @@ typedef u_int32_t port_t;
 
 //=======================================================================
 
+// A connection on its way to a worker
 class cli_t {
 public:
-  cli_t (child_t *ch, int cfd, const sockaddr_in &sin, ptr<axprt_unix> x,
-	 ptr<aclnt> _cli);
+  cli_t (child_t *ch, worker_t *w, int cfd, const sockaddr_in &sin);
   ~cli_t ();
 
   void run (evv_t ev, CLOSURE);
@@ -33,50 +34,87 @@ public:
 
 private:
   child_t *_server;
+  worker_t *_worker;
   int _cli_fd;
   sockaddr_in _cli_addr;
-  ptr<axprt_unix> _srv_x;
-  ptr<aclnt> _srv_cli;
   
   list_entry<cli_t> _lnk;
 };
 
 //=======================================================================
 
+//
+// One running copy of a port's server.  It is started when tinetd
+// starts, and started again crash_wait seconds after it exits.
+//
+class worker_t {
+public:
+  worker_t (child_t *ch, u_int i);
+  void start () { launch_loop (); }
+  bool up () const { return _x; }
+  ptr<axprt_unix> x () const { return _x; }
+  ptr<aclnt> cli () const { return _cli; }
+
+  // Connections handed to it whose handoff is not yet acknowledged;
+  // a busy worker is slow to take new ones.
+  u_int inflight () const { return _inflight; }
+  void handoff_begin () { _inflight++; }
+  void handoff_end (bool ok);
+  void report (strbuf &b) const;
+private:
+  void launch_loop (CLOSURE);
+  void launch ();
+  void wait_for_crash (evv_t ev, CLOSURE);
+
+  child_t *_child;
+  const u_int _idx;
+  ptr<axprt_unix> _x;
+  ptr<aclnt> _cli;
+  pid_t _pid;
+
+  u_int _inflight;
+  u_int64_t _nconn;		// Handed off since tinetd started
+  u_int64_t _nfail;
+  u_int _nstarts;
+};
+
+//=======================================================================
+
+//
+// A port, and the pool of workers its connections are spread over:
+// each goes to the running worker with the fewest handoffs in
+// flight, taking turns among those tied.
+//
 class child_t {
 public:
-  child_t (main_t *m, port_t port, const vec<str> &v);
+  child_t (main_t *m, port_t port, const vec<str> &v, u_int nworkers);
   port_t port () const { return _port; }
   bool init ();
   bool run ();
-  void newcon () { newcon_T (); }
+  void newcon ();
   void insert (cli_t *cli) { _clients.insert_head (cli); }
   void remove (cli_t *cli) { _clients.remove (cli); }
   str srvname () const { return _cmd[0]; }
+  const vec<str> &cmd () const { return _cmd; }
+  int crash_wait () const;
+  void launched ();
+  void report (strbuf &b) const;
 
   friend class main_t;
 private:
-  void newcon_T (CLOSURE);
+  void newcon_T (int fd, sockaddr_in sin, CLOSURE);
   void wait_for_it (evv_t ev);
-  void launch_loop (CLOSURE);
-  void launch ();
-  void wait_for_crash (evv_t ev, CLOSURE);
-
-
-  typedef enum { NONE = 0, CRASHED = 1, OK = 2 } state_t;
+  worker_t *pick ();
 
   main_t *_main;
   port_t _port;
   ihash_entry<child_t> _lnk;
 
   vec<str> _cmd;
-  state_t _state;
   int _lfd;
   vec<evv_t::ptr> _waiters;
-  ptr<axprt_unix> _x;
-  ptr<aclnt> _cli;
-  pid_t _pid;
-  evv_t::ptr _poke_ev;
+  vec<worker_t *> _workers;
+  u_int _next;
 
   list<cli_t, &cli_t::_lnk> _clients;
 };
@@ -91,6 +129,7 @@ public:
   bool run ();
   int crash_wait () const { return _crash_wait; }
   const struct in_addr &addr () const { return _addr; }
+  void report ();
 private:
   bool insert (child_t *ch);
   void usage ();
@@ -105,6 +144,7 @@ private:
   struct in_addr _addr;
   bool _daemonize;
   int _crash_wait;
+  u_int _nworkers;		// Per port
 };
 
 //=======================================================================